@@ -0,0 +1,97 @@
+// Benchmark an intrusive free list shared by several threads:
+// ra::intrusive::atomic_stack versus a mutex-guarded ra::intrusive::list.
+// Each thread repeatedly takes one object from the free list and returns
+// it. The reported time is the average per operation (take or return).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <ra/intrusive_atomic_stack.hpp>
+#include <ra/intrusive_list.hpp>
+#include <thread>
+#include <vector>
+
+struct object {
+    ra::intrusive::atomic_stack_hook stack_hook;
+    ra::intrusive::list_hook list_hook;
+    char payload[48];
+};
+
+using atomic_stack_t = ra::intrusive::atomic_stack<object, &object::stack_hook>;
+using list_t = ra::intrusive::list<object, &object::list_hook>;
+
+// A free list guarded by a mutex.
+class locked_list {
+    public:
+        void push(object& x) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            list_.push_back(x);
+        }
+
+        object* pop() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (list_.empty()) {
+                return nullptr;
+            }
+            object* x = &list_.back();
+            list_.pop_back();
+            return x;
+        }
+
+        void clear() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            list_.clear();
+        }
+
+    private:
+        std::mutex mutex_;
+        list_t list_;
+};
+
+// Returns the average time per operation (in ns) for the given number of
+// threads.
+template <class FreeList>
+double run(FreeList& free_list, int threads, int iterations) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                if (object* x = free_list.pop()) {
+                    x->payload[0] = static_cast<char>(i);
+                    free_list.push(*x);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (2.0 * threads * iterations);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    std::printf("%8s %16s %16s\n", "threads", "atomic_stack ns", "mutex+list ns");
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        std::vector<object> objects(static_cast<std::size_t>(threads) * 4);
+
+        atomic_stack_t stack;
+        locked_list list;
+        for (auto& x : objects) {
+            stack.push(x);
+            list.push(x);
+        }
+
+        double stack_ns = run(stack, threads, iterations);
+        double list_ns = run(list, threads, iterations);
+        std::printf("%8d %16.1f %16.1f\n", threads, stack_ns, list_ns);
+
+        stack.pop_all([](object&) {});
+        list.clear();
+    }
+}
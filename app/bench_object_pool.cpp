@@ -0,0 +1,80 @@
+// Benchmark the allocation of fixed-size messages: new/delete versus
+// ra::intrusive::object_pool with one cache per thread. Each thread keeps
+// a window of live messages, replacing the oldest one on every iteration.
+// The reported time is the average per operation pair (create and
+// destroy).
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ra/intrusive_object_pool.hpp>
+#include <thread>
+#include <vector>
+
+struct message {
+    explicit message(int id) : id(id) {}
+    int id;
+    char payload[60];
+};
+
+using pool_t = ra::intrusive::object_pool<message>;
+
+constexpr std::size_t window = 256;
+
+// Returns the average time per operation pair (in ns) for the given number
+// of threads, where the thread body is made by make_body.
+template <class MakeBody>
+double run(int threads, int iterations, MakeBody make_body) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(make_body(iterations));
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(threads) * iterations);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000000;
+
+    std::printf("%8s %16s %16s\n", "threads", "new/delete ns", "object_pool ns");
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        double heap_ns = run(threads, iterations, [](int n) {
+            return [n] {
+                std::vector<message*> live(window, nullptr);
+                for (int i = 0; i < n; ++i) {
+                    message*& slot = live[std::size_t(i) % window];
+                    delete slot;
+                    slot = new message(i);
+                }
+                for (message* m : live) {
+                    delete m;
+                }
+            };
+        });
+
+        pool_t pool;
+        double pool_ns = run(threads, iterations, [&pool](int n) {
+            return [n, &pool] {
+                pool_t::cache cache(pool);
+                std::vector<message*> live(window, nullptr);
+                for (int i = 0; i < n; ++i) {
+                    message*& slot = live[std::size_t(i) % window];
+                    if (slot) {
+                        cache.destroy(slot);
+                    }
+                    slot = cache.create(i);
+                }
+                for (message* m : live) {
+                    cache.destroy(m);
+                }
+            };
+        });
+
+        std::printf("%8d %16.1f %16.1f\n", threads, heap_ns, pool_ns);
+    }
+}
@@ -0,0 +1,85 @@
+// Benchmark a traversal of a list whose nodes are scattered across the heap:
+// a plain range-for loop versus ra::intrusive::for_each_prefetch with
+// several lookahead distances. The objects are allocated in one block and
+// linked in a random order, so consecutive nodes rarely share a cache line
+// or page. Each visit reads a field at the end of the object, on a
+// different cache line than the hook. The reported time is the average per
+// node.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <ra/intrusive_list.hpp>
+#include <ra/intrusive_prefetch.hpp>
+#include <vector>
+
+struct object {
+    ra::intrusive::list_hook hook;
+    char padding[112];
+    long value;
+};
+
+using list_t = ra::intrusive::list<object, &object::hook>;
+
+// Returns the average time per node (in ns) of the traversal f.
+template <class F>
+double run(std::size_t nodes, int passes, F f) {
+    long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        sum += f();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Keep the traversals from being optimized away.
+    if (sum == 42) {
+        std::printf("\n");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(nodes) * passes);
+}
+
+int main(int argc, char** argv) {
+    std::size_t nodes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    int passes = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::vector<object> objects(nodes);
+    std::vector<std::size_t> order(nodes);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(1));
+
+    list_t list;
+    for (std::size_t i = 0; i < nodes; ++i) {
+        objects[order[i]].value = long(i);
+        list.push_back(objects[order[i]]);
+    }
+
+    std::printf("%zu scattered nodes of %zu bytes\n", nodes, sizeof(object));
+    std::printf("%20s %10s\n", "traversal", "ns/node");
+
+    double plain_ns = run(nodes, passes, [&] {
+        long sum = 0;
+        for (const object& x : list) {
+            sum += x.value;
+        }
+        return sum;
+    });
+    std::printf("%20s %10.2f\n", "plain", plain_ns);
+
+    for (bool payload : {false, true}) {
+        for (std::size_t distance : {2, 4, 8, 16, 32}) {
+            double ns = run(nodes, passes, [&] {
+                long sum = 0;
+                ra::intrusive::for_each_prefetch(list, [&](const object& x) { sum += x.value; }, distance, payload);
+                return sum;
+            });
+            char label[32];
+            std::snprintf(label, sizeof(label), "%s d=%zu", payload ? "hook+payload" : "hook", distance);
+            std::printf("%20s %10.2f\n", label, ns);
+        }
+    }
+
+    list.clear();
+}
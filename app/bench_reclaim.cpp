@@ -0,0 +1,97 @@
+// Benchmark the read-side cost of safe memory reclamation: each reader
+// thread repeatedly enters a read-side critical section, loads a shared
+// pointer and reads the object it points to. The critical section is
+// either unprotected (the baseline, which is only safe if objects are
+// never freed), an ra::reclaim::epoch_domain pin, or an
+// ra::reclaim::hazard_domain protect/clear. The reported time is the
+// average per read.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ra/reclaim_epoch.hpp>
+#include <ra/reclaim_hazard_pointer.hpp>
+#include <thread>
+#include <vector>
+
+struct object {
+    explicit object(long value) : value(value) {}
+    long value;
+    ra::reclaim::retire_hook retire_hook;
+};
+
+using epoch_t = ra::reclaim::epoch_domain;
+using hazard_t = ra::reclaim::hazard_domain<1>;
+
+std::atomic<object*> shared{nullptr};
+
+// Returns the average time per read (in ns) for the given number of
+// threads, where the thread body is made by make_body.
+template <class MakeBody>
+double run(int threads, int iterations, MakeBody make_body) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(make_body(iterations));
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(threads) * iterations);
+}
+
+// Keeps the compiler from discarding the reads.
+std::atomic<long> sink{0};
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    epoch_t epoch;
+    hazard_t hazard;
+    shared.store(new object(1));
+
+    std::printf("%8s %12s %12s %12s\n", "threads", "unsafe ns", "epoch ns", "hazard ns");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double unsafe_ns = run(threads, iterations, [](int n) {
+            return [n] {
+                long sum = 0;
+                for (int i = 0; i < n; ++i) {
+                    sum += shared.load(std::memory_order_acquire)->value;
+                }
+                sink += sum;
+            };
+        });
+
+        double epoch_ns = run(threads, iterations, [&epoch](int n) {
+            return [&epoch, n] {
+                epoch_t::participant p(epoch);
+                long sum = 0;
+                for (int i = 0; i < n; ++i) {
+                    epoch_t::guard g(p);
+                    sum += shared.load(std::memory_order_acquire)->value;
+                }
+                sink += sum;
+            };
+        });
+
+        double hazard_ns = run(threads, iterations, [&hazard](int n) {
+            return [&hazard, n] {
+                hazard_t::participant p(hazard);
+                long sum = 0;
+                for (int i = 0; i < n; ++i) {
+                    sum += p.protect(0, shared)->value;
+                    p.clear(0);
+                }
+                sink += sum;
+            };
+        });
+
+        std::printf("%8d %12.2f %12.2f %12.2f\n", threads, unsafe_ns, epoch_ns, hazard_ns);
+    }
+
+    delete shared.load();
+}
@@ -0,0 +1,52 @@
+// Benchmark a short critical section guarded by ra::sync::mutex,
+// ra::sync::fair_mutex and std::mutex. Each thread repeatedly locks the mutex, increments a shared
+// counter and unlocks it. The reported time is the average per critical
+// section.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <ra/sync_mutex.hpp>
+#include <thread>
+#include <vector>
+
+// Returns the average time per critical section (in ns) for the given
+// number of threads.
+template <class Mutex>
+double run(int threads, int iterations) {
+    Mutex m;
+    long counter = 0;
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                std::lock_guard<Mutex> lock(m);
+                ++counter;
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (counter != long(threads) * iterations) {
+        std::abort();
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double(threads) * iterations);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::printf("%8s %12s %12s %12s\n", "threads", "mutex ns", "fair ns", "std ns");
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        double ra_ns = run<ra::sync::mutex>(threads, iterations);
+        double fair_ns = run<ra::sync::fair_mutex>(threads, iterations);
+        double std_ns = run<std::mutex>(threads, iterations);
+        std::printf("%8d %12.1f %12.1f %12.1f\n", threads, ra_ns, fair_ns, std_ns);
+    }
+}
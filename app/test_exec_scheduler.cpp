@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <ra/exec_scheduler.hpp>
+#include <ra/sv_set.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using ra::exec::scheduler;
+using ra::exec::task;
+
+task<int> answer() {
+    co_return 42;
+}
+
+task<int> add_one(task<int> t) {
+    int x = co_await t;
+    co_return x + 1;
+}
+
+TEST_CASE("Sync wait", "[scheduler]") {
+    scheduler s(2);
+    CHECK(s.size() == 2);
+    CHECK(!s.on_worker());
+
+    CHECK(s.sync_wait(answer()) == 42);
+    CHECK(s.sync_wait(add_one(answer())) == 43);
+}
+
+task<bool> on_worker(scheduler& s) {
+    bool before = s.on_worker();
+    co_await s.schedule();
+    co_return before && s.on_worker();
+}
+
+TEST_CASE("Schedule", "[scheduler]") {
+    scheduler s(2);
+    CHECK(s.sync_wait(on_worker(s)));
+}
+
+task<int> fail() {
+    throw std::runtime_error("failed");
+    co_return 0;
+}
+
+task<int> catch_failure() {
+    try {
+        co_return co_await fail();
+    } catch (const std::runtime_error&) {
+        co_return -1;
+    }
+}
+
+TEST_CASE("Exceptions", "[scheduler]") {
+    scheduler s(2);
+    CHECK_THROWS_AS(s.sync_wait(fail()), std::runtime_error);
+    CHECK(s.sync_wait(catch_failure()) == -1);
+}
+
+task<long> fib(scheduler& s, int n) {
+    if (n < 12) {
+        long a = 0, b = 1;
+        for (int i = 0; i < n; ++i) {
+            b = std::exchange(a, b) + b;
+        }
+        co_return a;
+    }
+    task<long> x = fib(s, n - 1);
+    task<long> y = fib(s, n - 2);
+    co_await s.when_all(x, y);
+    co_return co_await x + co_await y;
+}
+
+TEST_CASE("Fork and join", "[scheduler]") {
+    scheduler s(4);
+    CHECK(s.sync_wait(fib(s, 25)) == 75025);
+}
+
+task<void> count(std::atomic<int>& counter) {
+    counter.fetch_add(1);
+    co_return;
+}
+
+task<void> spawn_more(scheduler& s, std::atomic<int>& counter, int n) {
+    for (int i = 0; i < n; ++i) {
+        s.spawn(count(counter));
+    }
+    co_return;
+}
+
+TEST_CASE("Detached tasks", "[scheduler]") {
+    std::atomic<int> counter{0};
+    {
+        scheduler s(3);
+        for (int i = 0; i < 1000; ++i) {
+            s.spawn(count(counter));
+        }
+        for (int i = 0; i < 10; ++i) {
+            s.spawn(spawn_more(s, counter, 100));
+        }
+        // The destructor waits for the detached tasks.
+    }
+    CHECK(counter == 2000);
+}
+
+// Builds the sorted, unique contents of v[first, last) into out, forking
+// while the range is large.
+task<void> sort_unique(scheduler& s, std::vector<int>& v, std::size_t first, std::size_t last,
+                       std::vector<int>& out) {
+    if (last - first <= 4096) {
+        out.assign(v.begin() + first, v.begin() + last);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        co_return;
+    }
+
+    std::size_t middle = first + (last - first) / 2;
+    std::vector<int> left, right;
+    task<void> a = sort_unique(s, v, first, middle, left);
+    task<void> b = sort_unique(s, v, middle, last, right);
+    co_await s.when_all(a, b);
+
+    out.clear();
+    std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(out));
+}
+
+TEST_CASE("Parallel sv_set build", "[scheduler]") {
+    std::vector<int> keys(100000);
+    std::uint32_t x = 12345;
+    for (int& k : keys) {
+        x = x * 1664525u + 1013904223u;
+        k = static_cast<int>(x >> 12);
+    }
+
+    scheduler s(4);
+    std::vector<int> sorted;
+    s.sync_wait(sort_unique(s, keys, 0, keys.size(), sorted));
+
+    using set_t = ra::container::sv_set<int>;
+    set_t set(set_t::ordered_and_unique_range(), sorted.begin(), sorted.size());
+
+    std::vector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    CHECK(set.size() == expected.size());
+    CHECK(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+}
+
+TEST_CASE("Idle workers park and wake", "[scheduler]") {
+    scheduler s(4);
+    for (int round = 0; round < 50; ++round) {
+        // Let the workers go to sleep between rounds.
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        CHECK(s.sync_wait(fib(s, 16)) == 987);
+    }
+}
@@ -0,0 +1,100 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_atomic_stack.hpp>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct block {
+    explicit block(int id = 0) : id(id) {}
+    int id;
+    ra::intrusive::atomic_stack_hook hook;
+};
+
+using atomic_stack_t = ra::intrusive::atomic_stack<block, &block::hook>;
+
+TEST_CASE("Default constructor", "[atomic_stack]") {
+    atomic_stack_t stack;
+
+    CHECK(stack.empty());
+    CHECK(stack.pop() == nullptr);
+}
+
+TEST_CASE("Push and pop", "[atomic_stack]") {
+    atomic_stack_t stack;
+    block a(1), b(2), c(3);
+
+    stack.push(a);
+    stack.push(b);
+    CHECK(!stack.empty());
+    CHECK(stack.pop() == &b);
+
+    stack.push(c);
+    CHECK(stack.pop() == &c);
+    CHECK(stack.pop() == &a);
+    CHECK(stack.pop() == nullptr);
+    CHECK(stack.empty());
+}
+
+TEST_CASE("Batch transfer", "[atomic_stack]") {
+    atomic_stack_t stack;
+    std::vector<block> blocks;
+    for (int i = 0; i < 5; ++i) {
+        blocks.emplace_back(i);
+    }
+
+    stack.push(blocks[0]);
+    stack.push_list(blocks.begin() + 1, blocks.end());
+
+    // The stack is as if each element had been pushed in turn.
+    CHECK(stack.pop() == &blocks[4]);
+
+    std::vector<int> ids;
+    auto count = stack.pop_all([&](block& b) { ids.push_back(b.id); });
+    CHECK(count == 4);
+    CHECK(ids == std::vector<int>{3, 2, 1, 0});
+    CHECK(stack.empty());
+
+    stack.push_list(blocks.begin(), blocks.begin());
+    CHECK(stack.empty());
+    CHECK(stack.pop_all([](block&) {}) == 0);
+}
+
+TEST_CASE("Concurrent free list", "[atomic_stack]") {
+    constexpr int threads = 8;
+    constexpr int iterations = 20000;
+    constexpr int blocks_count = 64;
+
+    atomic_stack_t stack;
+    std::vector<block> blocks;
+    for (int i = 0; i < blocks_count; ++i) {
+        blocks.emplace_back(i);
+    }
+    stack.push_list(blocks.begin(), blocks.end());
+
+    // Each thread repeatedly takes blocks and gives them back.
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                block* x = stack.pop();
+                block* y = stack.pop();
+                if (x) {
+                    stack.push(*x);
+                }
+                if (y) {
+                    stack.push(*y);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // No block is lost or duplicated.
+    std::multiset<int> ids;
+    stack.pop_all([&](block& b) { ids.insert(b.id); });
+    CHECK(ids.size() == blocks_count);
+    CHECK(std::set<int>(ids.begin(), ids.end()).size() == blocks_count);
+}
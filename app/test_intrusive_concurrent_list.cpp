@@ -0,0 +1,192 @@
+#define CATCH_CONFIG_MAIN
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <ra/intrusive_concurrent_list.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct widget {
+        explicit widget(int v = 0) : value(v) {}
+
+        int value;
+        ra::intrusive::concurrent_list_hook hook;
+    };
+
+    using list_type = ra::intrusive::concurrent_list<widget, &widget::hook>;
+
+    std::vector<int> values(list_type& l) {
+        std::vector<int> v;
+        l.for_each_locked([&](widget& w) { v.push_back(w.value); });
+        return v;
+    }
+}  // namespace
+
+TEST_CASE("Single-threaded operations", "[concurrent_list]") {
+    std::vector<widget> ws;
+    for (int i = 0; i < 6; ++i) {
+        ws.emplace_back(i);
+    }
+    list_type l;
+    CHECK(l.empty());
+
+    l.push_back(ws[1]);
+    l.push_back(ws[3]);
+    l.push_front(ws[0]);
+    l.insert(ws[3], ws[2]);
+    l.push_back(ws[4]);
+    CHECK(l.size() == 5);
+    CHECK(values(l) == std::vector<int>{0, 1, 2, 3, 4});
+
+    l.erase(ws[2]);
+    l.erase(ws[0]);
+    l.erase(ws[4]);
+    CHECK(l.size() == 2);
+    CHECK(values(l) == std::vector<int>{1, 3});
+
+    CHECK(l.find_if([](const widget& w) { return w.value == 3; }) == &ws[3]);
+    CHECK(l.find_if([](const widget& w) { return w.value == 2; }) == nullptr);
+
+    // An erased element may be inserted again.
+    l.insert(ws[3], ws[2]);
+    l.insert_sorted(ws[5], [](const widget& a, const widget& b) { return a.value < b.value; });
+    l.insert_sorted(ws[0], [](const widget& a, const widget& b) { return a.value < b.value; });
+    CHECK(values(l) == std::vector<int>{0, 1, 2, 3, 5});
+    CHECK(l.count_if([](const widget& w) { return w.value % 2 == 1; }) == 3);
+
+    std::vector<int> disposed;
+    CHECK(l.erase_if([](const widget& w) { return w.value % 2 == 0; },
+                     [&](widget& w) { disposed.push_back(w.value); }) == 2);
+    CHECK(disposed == std::vector<int>{0, 2});
+    CHECK(values(l) == std::vector<int>{1, 3, 5});
+    CHECK(l.size() == 3);
+}
+
+TEST_CASE("Concurrent insertion and erasure", "[concurrent_list]") {
+    constexpr int threads = 4;
+    constexpr int per_thread = 64;
+    constexpr int rounds = 200;
+
+    // The elements are never freed while the list is in use, so readers may
+    // safely hold erased ones.
+    std::vector<widget> ws;
+    for (int i = 0; i < threads * per_thread; ++i) {
+        ws.emplace_back(i);
+    }
+    list_type l;
+
+    // Each thread owns a region of the list, delimited by an anchor that is
+    // never erased, and keeps inserting and erasing its own elements there.
+    std::vector<widget> anchors;
+    for (int t = 0; t < threads; ++t) {
+        anchors.emplace_back(-1);
+    }
+    for (auto& a : anchors) {
+        l.push_back(a);
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> failed(false);
+    std::thread reader([&] {
+        while (!stop.load()) {
+            // Anchors are always present, and every element seen is valid.
+            if (l.count_if([](const widget& w) { return w.value == -1; }) != threads) {
+                failed.store(true);
+            }
+            if (l.find_if([&](const widget& w) { return w.value < -1 || w.value >= threads * per_thread; })) {
+                failed.store(true);
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&, t] {
+            widget* first = &ws[t * per_thread];
+            for (int r = 0; r < rounds; ++r) {
+                for (int i = 0; i < per_thread; ++i) {
+                    if (i % 2 == 0) {
+                        l.insert(anchors[t], first[i]);
+                    } else {
+                        l.push_back(first[i]);
+                    }
+                }
+                for (int i = 0; i < per_thread; ++i) {
+                    l.erase(first[i]);
+                }
+            }
+            for (int i = 0; i < per_thread; ++i) {
+                l.insert(anchors[t], first[i]);
+            }
+        });
+    }
+    for (auto& w : writers) {
+        w.join();
+    }
+    stop.store(true);
+    reader.join();
+
+    CHECK(!failed.load());
+    CHECK(l.size() == threads + threads * per_thread);
+    std::vector<int> v = values(l);
+    CHECK(v.size() == l.size());
+    // Each region holds exactly its own elements, in insertion order.
+    for (int t = 0; t < threads; ++t) {
+        for (int i = 0; i < per_thread; ++i) {
+            CHECK(v[t * (per_thread + 1) + i] == t * per_thread + i);
+        }
+        CHECK(v[t * (per_thread + 1) + per_thread] == -1);
+    }
+}
+
+TEST_CASE("Concurrent sorted insertion", "[concurrent_list]") {
+    constexpr int threads = 4;
+    constexpr int per_thread = 500;
+
+    std::vector<widget> ws;
+    for (int i = 0; i < threads * per_thread; ++i) {
+        ws.emplace_back(i);
+    }
+    list_type l;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            // Interleave the values of the threads.
+            for (int i = t; i < threads * per_thread; i += threads) {
+                l.insert_sorted(ws[i], [](const widget& a, const widget& b) { return a.value < b.value; });
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    std::vector<int> v = values(l);
+    REQUIRE(v.size() == ws.size());
+    for (int i = 0; i < threads * per_thread; ++i) {
+        CHECK(v[i] == i);
+    }
+
+    // Erase the odd values in parallel with the hand-over-hand removal of
+    // multiples of three.
+    std::thread eraser([&] {
+        for (int i = 1; i < threads * per_thread; i += 2) {
+            if (i % 3 != 0) {
+                l.erase(ws[i]);
+            }
+        }
+    });
+    std::size_t removed = l.erase_if([](const widget& w) { return w.value % 3 == 0; });
+    eraser.join();
+
+    int expected = 0;
+    for (int i = 0; i < threads * per_thread; ++i) {
+        if (i % 2 == 0 && i % 3 != 0) {
+            ++expected;
+        }
+    }
+    CHECK(removed == std::size_t((threads * per_thread + 2) / 3));
+    CHECK(l.size() == std::size_t(expected));
+    CHECK(l.count_if([](const widget& w) { return w.value % 2 == 1 || w.value % 3 == 0; }) == 0);
+}
@@ -0,0 +1,607 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_list.hpp>
+#include <vector>
+
+struct widget {
+    explicit widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::list_hook hook;
+
+    bool operator<(const widget& other) const {
+        return value < other.value;
+    }
+};
+
+using list_t = ra::intrusive::list<widget, &widget::hook>;
+
+template <class List>
+std::vector<int> values(const List& list) {
+    std::vector<int> result;
+    for (const auto& w : list) {
+        result.push_back(w.value);
+    }
+    return result;
+}
+
+template <class List>
+std::vector<int> reverse_values(const List& list) {
+    std::vector<int> result;
+    for (auto it = list.end(); it != list.begin();) {
+        --it;
+        result.push_back(it->value);
+    }
+    return result;
+}
+
+TEST_CASE("Default constructor", "[list]") {
+    list_t list;
+
+    CHECK(list.size() == 0);
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+}
+
+TEST_CASE("Insert and erase", "[list]") {
+    widget a(1), b(2), c(3);
+    list_t list;
+
+    list.push_back(a);
+    list.push_back(c);
+    auto it = list.insert(++list.begin(), b);
+
+    CHECK(&*it == &b);
+    CHECK(list.size() == 3);
+    CHECK(values(list) == std::vector<int>{1, 2, 3});
+    CHECK(reverse_values(list) == std::vector<int>{3, 2, 1});
+    CHECK(&list.back() == &c);
+
+    it = list.erase(it);
+    CHECK(&*it == &c);
+    CHECK(values(list) == std::vector<int>{1, 3});
+
+    list.pop_back();
+    CHECK(values(list) == std::vector<int>{1});
+
+    list.clear();
+    CHECK(list.empty());
+}
+
+TEST_CASE("Move construct, move assign and swap", "[list]") {
+    widget a(1), b(2), c(3);
+
+    SECTION("Move construct") {
+        list_t list;
+        list.push_back(a);
+        list.push_back(b);
+
+        list_t list2(std::move(list));
+        CHECK(list.empty());
+        CHECK(list2.size() == 2);
+        CHECK(values(list2) == std::vector<int>{1, 2});
+        CHECK(reverse_values(list2) == std::vector<int>{2, 1});
+    }
+
+    SECTION("Move assign") {
+        list_t list, list2;
+        list.push_back(a);
+        list2.push_back(b);
+        list2.push_back(c);
+
+        list = std::move(list2);
+        CHECK(list2.empty());
+        CHECK(values(list) == std::vector<int>{2, 3});
+        CHECK(reverse_values(list) == std::vector<int>{3, 2});
+    }
+
+    SECTION("Swap with an empty list") {
+        list_t list, list2;
+        list.push_back(a);
+        list.push_back(b);
+
+        list.swap(list2);
+        CHECK(list.empty());
+        CHECK(list.size() == 0);
+        CHECK(values(list2) == std::vector<int>{1, 2});
+
+        list.push_back(c);
+        CHECK(values(list) == std::vector<int>{3});
+    }
+}
+
+TEST_CASE("Splice", "[list]") {
+    std::vector<widget> w;
+    for (int i = 0; i < 6; ++i) {
+        w.emplace_back(i);
+    }
+    list_t list, list2;
+    list.push_back(w[0]);
+    list.push_back(w[1]);
+    list.push_back(w[2]);
+    list2.push_back(w[3]);
+    list2.push_back(w[4]);
+    list2.push_back(w[5]);
+
+    SECTION("Whole list") {
+        list.splice(++list.begin(), list2);
+
+        CHECK(list2.empty());
+        CHECK(list2.size() == 0);
+        CHECK(list.size() == 6);
+        CHECK(values(list) == std::vector<int>{0, 3, 4, 5, 1, 2});
+        CHECK(reverse_values(list) == std::vector<int>{2, 1, 5, 4, 3, 0});
+    }
+
+    SECTION("Single element") {
+        list.splice(list.begin(), list2, ++list2.begin());
+
+        CHECK(values(list) == std::vector<int>{4, 0, 1, 2});
+        CHECK(values(list2) == std::vector<int>{3, 5});
+        CHECK(list.size() == 4);
+        CHECK(list2.size() == 2);
+    }
+
+    SECTION("Single element within a list") {
+        list.splice(list.begin(), list, --list.end());
+        CHECK(values(list) == std::vector<int>{2, 0, 1});
+
+        list.splice(list.begin(), list, list.begin());
+        CHECK(values(list) == std::vector<int>{2, 0, 1});
+        CHECK(list.size() == 3);
+    }
+
+    SECTION("Range") {
+        list.splice(list.end(), list2, list2.begin(), --list2.end());
+
+        CHECK(values(list) == std::vector<int>{0, 1, 2, 3, 4});
+        CHECK(values(list2) == std::vector<int>{5});
+        CHECK(list.size() == 5);
+        CHECK(list2.size() == 1);
+    }
+
+    SECTION("Range with count") {
+        list.splice(list.begin(), list2, ++list2.begin(), list2.end(), 2);
+
+        CHECK(values(list) == std::vector<int>{4, 5, 0, 1, 2});
+        CHECK(reverse_values(list) == std::vector<int>{2, 1, 0, 5, 4});
+        CHECK(values(list2) == std::vector<int>{3});
+        CHECK(list.size() == 5);
+        CHECK(list2.size() == 1);
+    }
+
+    SECTION("Range within a list") {
+        list.splice(list.begin(), list, ++list.begin(), list.end());
+
+        CHECK(values(list) == std::vector<int>{1, 2, 0});
+        CHECK(list.size() == 3);
+    }
+}
+
+TEST_CASE("Merge", "[list]") {
+    std::vector<widget> w;
+    for (int i : {1, 4, 4, 7, 0, 2, 4, 8, 9}) {
+        w.emplace_back(i);
+    }
+    list_t list, list2;
+    for (int i = 0; i < 4; ++i) {
+        list.push_back(w[i]);
+    }
+    for (int i = 4; i < 9; ++i) {
+        list2.push_back(w[i]);
+    }
+
+    SECTION("Default comparison") {
+        list.merge(list2);
+
+        CHECK(list2.empty());
+        CHECK(list.size() == 9);
+        CHECK(values(list) == std::vector<int>{0, 1, 2, 4, 4, 4, 7, 8, 9});
+        CHECK(reverse_values(list) == std::vector<int>{9, 8, 7, 4, 4, 4, 2, 1, 0});
+
+        // Equivalent elements from *this precede those from other.
+        auto it = list.begin();
+        std::advance(it, 3);
+        CHECK(&*it++ == &w[1]);
+        CHECK(&*it++ == &w[2]);
+        CHECK(&*it++ == &w[6]);
+    }
+
+    SECTION("Into an empty list") {
+        list_t list3;
+        list3.merge(list2, [](const widget& x, const widget& y) { return x.value < y.value; });
+
+        CHECK(list2.empty());
+        CHECK(values(list3) == std::vector<int>{0, 2, 4, 8, 9});
+    }
+}
+
+TEST_CASE("Sort", "[list]") {
+    std::vector<widget> w;
+    for (int i : {5, 3, 9, 3, 1, 8, 0, 3, 7, 2, 6}) {
+        w.emplace_back(i);
+    }
+    list_t list;
+
+    SECTION("Empty and single element lists") {
+        list.sort();
+        CHECK(list.empty());
+
+        list.push_back(w[0]);
+        list.sort();
+        CHECK(values(list) == std::vector<int>{5});
+    }
+
+    SECTION("Default comparison") {
+        for (auto& x : w) {
+            list.push_back(x);
+        }
+        list.sort();
+
+        CHECK(list.size() == w.size());
+        CHECK(values(list) == std::vector<int>{0, 1, 2, 3, 3, 3, 5, 6, 7, 8, 9});
+        CHECK(reverse_values(list) == std::vector<int>{9, 8, 7, 6, 5, 3, 3, 3, 2, 1, 0});
+
+        // The sort is stable.
+        auto it = list.begin();
+        std::advance(it, 3);
+        CHECK(&*it++ == &w[1]);
+        CHECK(&*it++ == &w[3]);
+        CHECK(&*it++ == &w[7]);
+    }
+
+    SECTION("Custom comparison") {
+        for (auto& x : w) {
+            list.push_back(x);
+        }
+        list.sort([](const widget& x, const widget& y) { return x.value > y.value; });
+
+        CHECK(values(list) == std::vector<int>{9, 8, 7, 6, 5, 3, 3, 3, 2, 1, 0});
+        CHECK(reverse_values(list) == std::vector<int>{0, 1, 2, 3, 3, 3, 5, 6, 7, 8, 9});
+    }
+
+    SECTION("Larger list") {
+        std::vector<widget> many;
+        for (int i = 0; i < 1000; ++i) {
+            many.emplace_back((i * 7919) % 1000);
+        }
+        for (auto& x : many) {
+            list.push_back(x);
+        }
+        list.sort();
+
+        std::vector<int> expected(1000);
+        for (int i = 0; i < 1000; ++i) {
+            expected[i] = i;
+        }
+        CHECK(values(list) == expected);
+        list.clear();
+    }
+}
+
+TEST_CASE("Unique and reverse", "[list]") {
+    std::vector<widget> w;
+    for (int i : {1, 1, 2, 3, 3, 3, 1}) {
+        w.emplace_back(i);
+    }
+    list_t list;
+    for (auto& x : w) {
+        list.push_back(x);
+    }
+
+    SECTION("Unique") {
+        auto count = list.unique([](const widget& x, const widget& y) { return x.value == y.value; });
+
+        CHECK(count == 3);
+        CHECK(list.size() == 4);
+        CHECK(values(list) == std::vector<int>{1, 2, 3, 1});
+        CHECK(reverse_values(list) == std::vector<int>{1, 3, 2, 1});
+        CHECK(&list.back() == &w[6]);
+    }
+
+    SECTION("Reverse") {
+        list.reverse();
+
+        CHECK(values(list) == std::vector<int>{1, 3, 3, 3, 2, 1, 1});
+        CHECK(reverse_values(list) == std::vector<int>{1, 1, 2, 3, 3, 3, 1});
+        CHECK(&list.back() == &w[0]);
+
+        list_t empty;
+        empty.reverse();
+        CHECK(empty.empty());
+    }
+}
+
+TEST_CASE("Iterator to", "[list]") {
+    widget a(1), b(2), c(3);
+    list_t list;
+    list.push_back(a);
+    list.push_back(b);
+    list.push_back(c);
+
+    auto it = list.iterator_to(b);
+    CHECK(&*it == &b);
+    CHECK(&*--it == &a);
+
+    const list_t& const_list = list;
+    list_t::const_iterator cit = const_list.iterator_to(c);
+    CHECK(&*cit == &c);
+    CHECK(++cit == list.end());
+
+    // Self-removal without traversal.
+    list.erase(list_t::s_iterator_to(b));
+    CHECK(values(list) == std::vector<int>{1, 3});
+}
+
+TEST_CASE("Clear and dispose", "[list]") {
+    list_t list;
+    std::vector<int> disposed;
+
+    SECTION("Disposer visits every element in order") {
+        for (int i = 0; i < 4; ++i) {
+            list.push_back(*new widget(i));
+        }
+
+        list.clear_and_dispose([&](widget& w) {
+            disposed.push_back(w.value);
+            delete &w;
+        });
+        CHECK(list.empty());
+        CHECK(list.size() == 0);
+        CHECK(disposed == std::vector<int>{0, 1, 2, 3});
+    }
+
+    SECTION("Unsafe clear forgets the elements") {
+        widget a(1), b(2), c(3);
+        list.push_back(a);
+        list.push_back(b);
+
+        list.unsafe_clear();
+        CHECK(list.empty());
+        CHECK(list.size() == 0);
+
+        // The stale hooks may be reinserted.
+        list.push_back(b);
+        list.push_back(c);
+        list.push_back(a);
+        CHECK(values(list) == std::vector<int>{2, 3, 1});
+        CHECK(reverse_values(list) == std::vector<int>{1, 3, 2});
+        list.clear();
+        CHECK(list.empty());
+    }
+}
+
+struct safe_widget {
+    explicit safe_widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::basic_list_hook<ra::intrusive::link_mode::safe> hook;
+};
+
+TEST_CASE("Safe link mode", "[list]") {
+    using safe_list_t = ra::intrusive::list<safe_widget, &safe_widget::hook>;
+    safe_widget a(1), b(2);
+    safe_list_t list;
+
+    CHECK(!a.hook.is_linked());
+    list.push_back(a);
+    list.push_back(b);
+    CHECK(a.hook.is_linked());
+    CHECK(list.size() == 2);
+
+    list.erase(list.iterator_to(a));
+    CHECK(!a.hook.is_linked());
+    CHECK(b.hook.is_linked());
+
+    list.clear();
+    CHECK(!b.hook.is_linked());
+
+    list.push_back(a);
+    list.push_back(b);
+    int count = 0;
+    list.clear_and_dispose([&](safe_widget& w) {
+        CHECK(!w.hook.is_linked());
+        ++count;
+    });
+    CHECK(count == 2);
+    CHECK(list.empty());
+
+    // Hooks left in a chain are reset when it is cleared.
+    {
+        safe_list_t::chain chain;
+        chain.push_back(a);
+        chain.push_back(b);
+        CHECK(a.hook.is_linked());
+    }
+    CHECK(!a.hook.is_linked());
+    CHECK(!b.hook.is_linked());
+}
+
+struct auto_widget {
+    explicit auto_widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::basic_list_hook<ra::intrusive::link_mode::auto_unlink> hook;
+};
+
+TEST_CASE("Auto-unlink mode", "[list]") {
+    using auto_list_t = ra::intrusive::list<auto_widget, &auto_widget::hook>;
+    static_assert(!auto_list_t::constant_time_size);
+
+    auto_list_t list;
+    auto_widget a(1), c(3);
+    list.push_back(a);
+
+    SECTION("Destruction unlinks") {
+        {
+            auto_widget b(2);
+            list.push_back(b);
+            list.push_back(c);
+            CHECK(list.size() == 3);
+        }
+
+        CHECK(list.size() == 2);
+        CHECK(values(list) == std::vector<int>{1, 3});
+        CHECK(reverse_values(list) == std::vector<int>{3, 1});
+    }
+
+    SECTION("Explicit unlink") {
+        list.push_back(c);
+        a.hook.unlink();
+
+        CHECK(!a.hook.is_linked());
+        CHECK(values(list) == std::vector<int>{3});
+
+        // Unlinking an unlinked hook has no effect.
+        a.hook.unlink();
+        CHECK(list.size() == 1);
+    }
+
+    SECTION("Splice without a count") {
+        auto_widget d(4);
+        auto_list_t list2;
+        list2.push_back(c);
+        list2.push_back(d);
+
+        list.splice(list.end(), list2, list2.begin(), list2.end());
+        CHECK(values(list) == std::vector<int>{1, 3, 4});
+        CHECK(list2.empty());
+        list.clear();
+    }
+}
+
+TEST_CASE("Bulk insertion", "[list]") {
+    std::vector<widget> widgets;
+    for (int i = 0; i < 5; ++i) {
+        widgets.emplace_back(i);
+    }
+    widget a(10), b(11);
+    list_t list;
+    list.push_back(a);
+    list.push_back(b);
+
+    SECTION("Range in the middle") {
+        auto it = list.insert(list.iterator_to(b), widgets.begin(), widgets.end());
+        CHECK(&*it == &widgets[0]);
+        CHECK(list.size() == 7);
+        CHECK(values(list) == std::vector<int>{10, 0, 1, 2, 3, 4, 11});
+        CHECK(reverse_values(list) == std::vector<int>{11, 4, 3, 2, 1, 0, 10});
+    }
+
+    SECTION("Range at either end") {
+        list.insert(list.end(), widgets.begin() + 3, widgets.end());
+        list.insert(list.begin(), widgets.begin(), widgets.begin() + 3);
+        CHECK(values(list) == std::vector<int>{0, 1, 2, 10, 11, 3, 4});
+        CHECK(reverse_values(list) == std::vector<int>{4, 3, 11, 10, 2, 1, 0});
+    }
+
+    SECTION("Empty range") {
+        auto it = list.insert(list.end(), widgets.begin(), widgets.begin());
+        CHECK(it == list.end());
+        CHECK(values(list) == std::vector<int>{10, 11});
+    }
+
+    SECTION("Chains") {
+        list_t::chain chain;
+        CHECK(chain.empty());
+        for (auto& w : widgets) {
+            chain.push_back(w);
+        }
+        CHECK(chain.size() == 5);
+
+        list.push_back_chain(chain);
+        CHECK(chain.empty());
+        CHECK(list.size() == 7);
+        CHECK(values(list) == std::vector<int>{10, 11, 0, 1, 2, 3, 4});
+        CHECK(reverse_values(list) == std::vector<int>{4, 3, 2, 1, 0, 11, 10});
+
+        widget c(12);
+        chain.push_back(c);
+        list.insert_chain(list.iterator_to(b), chain);
+        CHECK(values(list) == std::vector<int>{10, 12, 11, 0, 1, 2, 3, 4});
+
+        // Attaching an empty chain has no effect.
+        list.push_back_chain(chain);
+        CHECK(list.size() == 8);
+    }
+
+    list.clear();
+}
+
+TEST_CASE("Untracked size", "[list]") {
+    using untracked_list_t = ra::intrusive::list<widget, &widget::hook, false>;
+    static_assert(list_t::constant_time_size);
+    static_assert(!untracked_list_t::constant_time_size);
+    CHECK(sizeof(untracked_list_t) < sizeof(list_t));
+
+    widget a(1), b(2), c(3), d(4), e(5);
+    untracked_list_t x, y;
+    x.push_back(a);
+    x.push_back(b);
+    x.push_back(c);
+    y.push_back(d);
+    y.push_back(e);
+    CHECK(x.size() == 3);
+
+    // A range splice between lists needs no count.
+    x.splice(x.begin(), y, y.begin(), y.end());
+    CHECK(values(x) == std::vector<int>{4, 5, 1, 2, 3});
+    CHECK(y.empty());
+    CHECK(x.size() == 5);
+
+    y.splice(y.end(), x, x.iterator_to(b), x.end());
+    CHECK(values(x) == std::vector<int>{4, 5, 1});
+    CHECK(values(y) == std::vector<int>{2, 3});
+
+    x.merge(y);
+    x.sort();
+    CHECK(values(x) == std::vector<int>{1, 2, 3, 4, 5});
+    CHECK(reverse_values(x) == std::vector<int>{5, 4, 3, 2, 1});
+
+    x.swap(y);
+    CHECK(x.size() == 0);
+    CHECK(y.size() == 5);
+    y.clear();
+}
+
+struct job : ra::intrusive::list_hook {
+    explicit job(int value) : value(value) {}
+    int value;
+    ra::intrusive::list_hook run_hook;
+    ra::intrusive::list_hook owner_hook;
+};
+
+TEST_CASE("Hook selection", "[list]") {
+    using base_list_t = ra::intrusive::list<job, ra::intrusive::base_hook<ra::intrusive::list_hook>>;
+    using run_list_t = ra::intrusive::list<job, &job::run_hook>;
+    using owner_list_t = ra::intrusive::list<job, &job::owner_hook>;
+
+    job a(1), b(2), c(3);
+
+    constexpr auto offset = ra::util::constexpr_offset_from_pointer_to_member(&job::owner_hook);
+    CHECK(reinterpret_cast<char*>(&a) + offset == reinterpret_cast<char*>(&a.owner_hook));
+    base_list_t all;
+    run_list_t run;
+    owner_list_t owner;
+
+    all.push_back(a);
+    all.push_back(b);
+    all.push_back(c);
+    run.push_back(c);
+    run.push_back(a);
+    owner.push_back(b);
+
+    // Each list links the same objects through a different hook.
+    CHECK(values(all) == std::vector<int>{1, 2, 3});
+    CHECK(values(run) == std::vector<int>{3, 1});
+    CHECK(values(owner) == std::vector<int>{2});
+    CHECK(reverse_values(all) == std::vector<int>{3, 2, 1});
+
+    CHECK(&*run.iterator_to(a) == &a);
+    CHECK(&*all.iterator_to(c) == &c);
+
+    all.erase(all.iterator_to(b));
+    CHECK(values(all) == std::vector<int>{1, 3});
+    CHECK(values(owner) == std::vector<int>{2});
+
+    all.clear();
+    run.clear();
+    owner.clear();
+}
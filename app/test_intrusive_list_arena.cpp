@@ -0,0 +1,162 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <map>
+#include <ra/intrusive_list_arena.hpp>
+#include <vector>
+
+struct widget {
+    explicit widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::list_hook hook;
+};
+
+using arena_t = ra::intrusive::list_arena<widget, &widget::hook>;
+using list_t = arena_t::list_type;
+
+template <class List>
+std::vector<int> values(const List& list) {
+    std::vector<int> result;
+    for (const auto& w : list) {
+        result.push_back(w.value);
+    }
+    return result;
+}
+
+template <class List>
+std::vector<int> reverse_values(const List& list) {
+    std::vector<int> result;
+    for (auto it = list.end(); it != list.begin();) {
+        --it;
+        result.push_back(it->value);
+    }
+    return result;
+}
+
+// Returns true if the elements of the list are adjacent in list order.
+bool is_compact(const list_t& list) {
+    const widget* prev = nullptr;
+    for (const auto& w : list) {
+        if (prev && &w != prev + 1) {
+            return false;
+        }
+        prev = &w;
+    }
+    return true;
+}
+
+// Destroys the elements of the list.
+void destroy_all(arena_t& arena, list_t& list) {
+    list.clear_and_dispose([&](widget& w) { arena.destroy(w); });
+}
+
+TEST_CASE("Create and destroy", "[list_arena]") {
+    arena_t arena(2);
+    CHECK(arena.capacity() == 2);
+
+    widget* a = arena.create(1);
+    widget* b = arena.create(2);
+    CHECK(arena.create(3) == nullptr);
+    CHECK(arena.size() == 2);
+    CHECK(arena.contains(*a));
+    CHECK(arena.contains(*b));
+
+    widget outside(4);
+    CHECK(!arena.contains(outside));
+
+    arena.destroy(*a);
+    CHECK(arena.size() == 1);
+    widget* c = arena.create(3);
+    CHECK(c == a);
+    CHECK(c->value == 3);
+}
+
+TEST_CASE("Compaction", "[list_arena]") {
+    constexpr int n = 64;
+    arena_t arena(2 * n);
+    std::vector<widget*> created;
+    for (int i = 0; i < 2 * n; ++i) {
+        created.push_back(arena.create(i));
+    }
+
+    // Keep every other object, linked in reverse order.
+    list_t list;
+    list_t others;
+    for (int i = 2 * n - 1; i >= 0; --i) {
+        if (i % 2 == 0) {
+            list.push_back(*created[i]);
+        } else {
+            others.push_back(*created[i]);
+        }
+    }
+    std::vector<int> expected = values(list);
+    std::vector<int> expected_others = values(others);
+    CHECK(!is_compact(list));
+
+    SECTION("In a single call") {
+        std::map<int, const widget*> moved;
+        CHECK(arena.compact_steps(list, 1000, [&](const widget*, widget& to) { moved[to.value] = &to; }));
+
+        CHECK(is_compact(list));
+        CHECK(&*list.begin() == created[0]);
+        CHECK(values(list) == expected);
+        CHECK(reverse_values(list) == std::vector<int>(expected.rbegin(), expected.rend()));
+        CHECK(values(others) == expected_others);
+        CHECK(arena.size() == 2 * n);
+
+        // The callback reports the final address of every moved element.
+        for (const auto& w : list) {
+            if (moved.count(w.value)) {
+                CHECK(moved[w.value] == &w);
+            }
+        }
+    }
+
+    SECTION("Incrementally, with interleaved updates") {
+        int calls = 0;
+        while (!arena.compact_steps(list, 5)) {
+            ++calls;
+            if (calls == 3) {
+                // Erase and destroy an element of the compacted prefix.
+                widget& w = *list.begin();
+                list.erase(list.begin());
+                arena.destroy(w);
+                expected.erase(expected.begin());
+            }
+        }
+        CHECK(calls > 3);
+        CHECK(values(list) == expected);
+        CHECK(values(others) == expected_others);
+
+        // A second pass settles what the interruption left behind.
+        while (!arena.compact_steps(list, 5)) {
+        }
+        CHECK(is_compact(list));
+        CHECK(values(list) == expected);
+    }
+
+    SECTION("Within a time budget") {
+        while (!arena.compact_for(list, std::chrono::microseconds(50))) {
+        }
+        CHECK(is_compact(list));
+        CHECK(values(list) == expected);
+    }
+
+    destroy_all(arena, list);
+    destroy_all(arena, others);
+    CHECK(arena.size() == 0);
+}
+
+TEST_CASE("Replace node", "[list]") {
+    widget a(1), b(2), c(3), d(4);
+    list_t list;
+    list.push_back(a);
+    list.push_back(b);
+    list.push_back(c);
+
+    list_t::replace_node(list.iterator_to(b), d);
+    CHECK(values(list) == std::vector<int>{1, 4, 3});
+    CHECK(reverse_values(list) == std::vector<int>{3, 4, 1});
+    CHECK(list.size() == 3);
+    list.clear();
+}
@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_lru_cache.hpp>
+#include <string>
+#include <vector>
+
+struct entry {
+    entry(int key, std::string value) : key(key), value(std::move(value)) {}
+    int key;
+    std::string value;
+    ra::intrusive::list_hook lru_hook;
+    ra::intrusive::lru_cache_hook index_hook;
+};
+
+struct key_of_entry {
+    int operator()(const entry& e) const {
+        return e.key;
+    }
+};
+
+using cache_t = ra::intrusive::lru_cache<entry, key_of_entry, &entry::lru_hook, &entry::index_hook>;
+
+TEST_CASE("Construct a cache", "[lru_cache]") {
+    cache_t cache(4);
+
+    CHECK(cache.size() == 0);
+    CHECK(cache.capacity() == 4);
+    CHECK(cache.empty());
+    CHECK(!cache.full());
+    CHECK(cache.find(1) == nullptr);
+    CHECK(cache.evict() == nullptr);
+}
+
+TEST_CASE("Insert, find and erase", "[lru_cache]") {
+    cache_t cache(4);
+    entry a(1, "a"), b(2, "b"), b2(2, "b2");
+
+    CHECK(cache.insert(a) == std::make_pair(&a, true));
+    CHECK(cache.insert(b) == std::make_pair(&b, true));
+    CHECK(cache.insert(b2) == std::make_pair(&b, false));
+    CHECK(cache.size() == 2);
+
+    CHECK(cache.find(1) == &a);
+    CHECK(cache.get(2) == &b);
+    CHECK(cache.find(3) == nullptr);
+
+    cache.erase(a);
+    CHECK(cache.find(1) == nullptr);
+    CHECK(cache.size() == 1);
+
+    cache.clear();
+    CHECK(cache.empty());
+}
+
+TEST_CASE("Eviction order", "[lru_cache]") {
+    std::vector<entry> entries;
+    for (int i = 0; i < 4; ++i) {
+        entries.emplace_back(i, std::to_string(i));
+    }
+    cache_t cache(4);
+    for (auto& e : entries) {
+        cache.insert(e);
+    }
+    CHECK(cache.full());
+
+    SECTION("Least recently inserted first") {
+        CHECK(cache.evict() == &entries[0]);
+        CHECK(cache.evict() == &entries[1]);
+        CHECK(!cache.full());
+        CHECK(cache.find(0) == nullptr);
+    }
+
+    SECTION("Touch promotes immediately") {
+        cache.touch(entries[0]);
+
+        CHECK(cache.evict() == &entries[1]);
+        CHECK(cache.evict() == &entries[2]);
+        CHECK(cache.evict() == &entries[3]);
+        CHECK(cache.evict() == &entries[0]);
+        CHECK(cache.evict() == nullptr);
+    }
+
+    SECTION("Hits are promoted on eviction") {
+        CHECK(cache.get(0) == &entries[0]);
+        CHECK(cache.get(2) == &entries[2]);
+        CHECK(cache.get(2) == &entries[2]);
+
+        // Entries 0 and 2 get a second chance.
+        CHECK(cache.evict() == &entries[1]);
+        CHECK(cache.evict() == &entries[3]);
+        CHECK(cache.evict() == &entries[0]);
+        CHECK(cache.evict() == &entries[2]);
+    }
+
+    SECTION("Reuse an evicted entry") {
+        entry* victim = cache.evict();
+        victim->key = 10;
+        CHECK(cache.insert(*victim).second);
+        CHECK(cache.find(10) == victim);
+        CHECK(cache.find(0) == nullptr);
+    }
+}
+
+TEST_CASE("Many entries with colliding buckets", "[lru_cache]") {
+    std::vector<entry> entries;
+    for (int i = 0; i < 100; ++i) {
+        entries.emplace_back(i * 16, "");
+    }
+    cache_t cache(8);
+    for (auto& e : entries) {
+        cache.insert(e);
+    }
+
+    CHECK(cache.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        CHECK(cache.find(i * 16) == &entries[i]);
+    }
+
+    for (int i = 0; i < 100; i += 2) {
+        cache.erase(entries[i]);
+    }
+    CHECK(cache.size() == 50);
+    CHECK(cache.find(0) == nullptr);
+    CHECK(cache.find(16) == &entries[1]);
+    CHECK(cache.evict() == &entries[1]);
+}
@@ -0,0 +1,103 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_mpsc_queue.hpp>
+#include <thread>
+#include <vector>
+
+struct message {
+    message() = default;
+    message(int producer, int sequence) : producer(producer), sequence(sequence) {}
+    int producer = 0;
+    int sequence = 0;
+    ra::intrusive::mpsc_queue_hook hook;
+};
+
+using queue_t = ra::intrusive::mpsc_queue<message, &message::hook>;
+
+TEST_CASE("Default constructor", "[mpsc_queue]") {
+    queue_t queue;
+
+    CHECK(queue.empty());
+    CHECK(queue.pop() == nullptr);
+}
+
+TEST_CASE("Single thread FIFO order", "[mpsc_queue]") {
+    queue_t queue;
+    message a(0, 1), b(0, 2), c(0, 3);
+
+    queue.push(a);
+    queue.push(b);
+    CHECK(!queue.empty());
+    CHECK(queue.pop() == &a);
+
+    queue.push(c);
+    CHECK(queue.pop() == &b);
+    CHECK(queue.pop() == &c);
+    CHECK(queue.pop() == nullptr);
+    CHECK(queue.empty());
+
+    SECTION("Elements can be pushed again after being popped") {
+        queue.push(a);
+        queue.push(c);
+        CHECK(queue.pop() == &a);
+        queue.push(a);
+        CHECK(queue.pop() == &c);
+        CHECK(queue.pop() == &a);
+        CHECK(queue.empty());
+    }
+
+    SECTION("Pop all") {
+        queue.push(c);
+        queue.push(b);
+        queue.push(a);
+
+        std::vector<message*> popped;
+        auto count = queue.pop_all([&](message& m) { popped.push_back(&m); });
+
+        CHECK(count == 3);
+        CHECK(popped == std::vector<message*>{&c, &b, &a});
+        CHECK(queue.empty());
+    }
+}
+
+TEST_CASE("Multiple producers", "[mpsc_queue]") {
+    constexpr int producers = 4;
+    constexpr int per_producer = 20000;
+
+    queue_t queue;
+    std::vector<std::vector<message>> messages(producers);
+    for (int p = 0; p < producers; ++p) {
+        for (int i = 0; i < per_producer; ++i) {
+            messages[p].emplace_back(p, i);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (auto& m : messages[p]) {
+                queue.push(m);
+            }
+        });
+    }
+
+    // Each producer's messages are received in the order they were pushed.
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * per_producer) {
+        received += static_cast<int>(queue.pop_all([&](message& m) {
+            ordered = ordered && m.sequence == next[m.producer];
+            ++next[m.producer];
+        }));
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    CHECK(ordered);
+    CHECK(received == producers * per_producer);
+    CHECK(queue.pop() == nullptr);
+    CHECK(queue.empty());
+}
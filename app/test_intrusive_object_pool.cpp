@@ -0,0 +1,173 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_object_pool.hpp>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+struct message {
+    explicit message(int id = 0) : id(id) {
+        ++live;
+    }
+    ~message() {
+        --live;
+    }
+    int id;
+    char payload[52];
+
+    static inline int live = 0;
+};
+
+using pool_t = ra::intrusive::object_pool<message, 4096>;
+
+TEST_CASE("Create and destroy", "[object_pool]") {
+    pool_t pool(8);
+    CHECK(pool.magazine_size() == 8);
+    CHECK(pool.slab_count() == 0);
+
+    {
+        pool_t::cache cache(pool);
+        message* a = cache.create(1);
+        message* b = cache.create(2);
+        CHECK(a->id == 1);
+        CHECK(b->id == 2);
+        CHECK(a != b);
+        CHECK(message::live == 2);
+        CHECK(pool.slab_count() == 1);
+
+        // Slots of a slab are handed out in address order.
+        CHECK(reinterpret_cast<char*>(b) > reinterpret_cast<char*>(a));
+
+        cache.destroy(a);
+        CHECK(message::live == 1);
+
+        // The most recently freed slot is reused first.
+        message* c = cache.create(3);
+        CHECK(c == a);
+
+        cache.destroy(b);
+        cache.destroy(c);
+    }
+    CHECK(message::live == 0);
+}
+
+TEST_CASE("Construction failure frees the slot", "[object_pool]") {
+    struct fragile {
+        explicit fragile(bool fail) {
+            if (fail) {
+                throw std::runtime_error("fail");
+            }
+        }
+    };
+    ra::intrusive::object_pool<fragile, 4096> pool;
+    ra::intrusive::object_pool<fragile, 4096>::cache cache(pool);
+
+    fragile* a = cache.create(false);
+    CHECK_THROWS_AS(cache.create(true), std::runtime_error);
+    fragile* b = cache.create(false);
+    CHECK(a != b);
+    cache.destroy(a);
+    cache.destroy(b);
+}
+
+TEST_CASE("Slabs are returned by trim", "[object_pool]") {
+    pool_t pool(4);
+    const std::size_t count = 3 * pool_t::objects_per_slab;
+    std::vector<message*> messages;
+
+    {
+        pool_t::cache cache(pool);
+        for (std::size_t i = 0; i < count; ++i) {
+            messages.push_back(cache.create(int(i)));
+        }
+        CHECK(pool.slab_count() == 3);
+
+        // Nothing is free yet.
+        CHECK(pool.trim() == 0);
+
+        // Free all of the objects of the first slab, and one of the second.
+        for (std::size_t i = 0; i <= pool_t::objects_per_slab; ++i) {
+            cache.destroy(messages[i]);
+        }
+        cache.flush();
+        CHECK(cache.size() == 0);
+    }
+
+    CHECK(pool.trim() == 1);
+    CHECK(pool.slab_count() == 2);
+
+    // The remaining free slot is still available.
+    pool_t::cache cache(pool);
+    message* x = cache.create(-1);
+    CHECK(x == messages[pool_t::objects_per_slab]);
+    cache.destroy(x);
+
+    for (std::size_t i = pool_t::objects_per_slab + 1; i < count; ++i) {
+        cache.destroy(messages[i]);
+    }
+    cache.flush();
+    CHECK(pool.trim() == 2);
+    CHECK(pool.slab_count() == 0);
+    CHECK(message::live == 0);
+}
+
+TEST_CASE("Concurrent producers and consumers", "[object_pool]") {
+    constexpr int threads = 8;
+    constexpr int iterations = 20000;
+
+    pool_t pool(16);
+    std::vector<std::vector<message*>> kept(threads);
+
+    // Each thread creates batches of objects and destroys most of them,
+    // keeping one object per batch.
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            pool_t::cache cache(pool);
+            std::vector<message*> batch;
+            for (int i = 0; i < iterations; ++i) {
+                batch.push_back(cache.create(t * iterations + i));
+                if (batch.size() == 50) {
+                    kept[t].push_back(batch.back());
+                    batch.pop_back();
+                    for (message* m : batch) {
+                        cache.destroy(m);
+                    }
+                    batch.clear();
+                }
+            }
+            for (message* m : batch) {
+                cache.destroy(m);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // Every kept object is distinct and intact.
+    std::set<int> ids;
+    std::set<message*> addresses;
+    for (auto& v : kept) {
+        for (message* m : v) {
+            ids.insert(m->id);
+            addresses.insert(m);
+        }
+    }
+    CHECK(ids.size() == threads * (iterations / 50));
+    CHECK(addresses.size() == ids.size());
+    CHECK(message::live == int(ids.size()));
+
+    // Destroy them from another thread's cache.
+    pool_t::cache cache(pool);
+    for (auto& v : kept) {
+        for (message* m : v) {
+            cache.destroy(m);
+        }
+    }
+    cache.flush();
+    CHECK(message::live == 0);
+    pool.trim();
+    CHECK(pool.slab_count() == 0);
+}
@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_offset_list.hpp>
+#include <vector>
+
+struct item {
+    explicit item(int value = 0) : value(value) {}
+    int value;
+    ra::intrusive::offset_list_hook hook;
+};
+
+using list_t = ra::intrusive::offset_list<item, &item::hook>;
+
+std::vector<int> values(const list_t& list) {
+    std::vector<int> result;
+    for (const auto& x : list) {
+        result.push_back(x.value);
+    }
+    return result;
+}
+
+std::vector<int> reverse_values(const list_t& list) {
+    std::vector<int> result;
+    for (auto it = list.end(); it != list.begin();) {
+        --it;
+        result.push_back(it->value);
+    }
+    return result;
+}
+
+std::vector<item> make_arena(int n) {
+    std::vector<item> arena;
+    for (int i = 0; i < n; ++i) {
+        arena.emplace_back(i);
+    }
+    return arena;
+}
+
+TEST_CASE("offset_list_hook is two 32-bit indices") {
+    CHECK(sizeof(ra::intrusive::offset_list_hook) == 8);
+}
+
+TEST_CASE("offset_list push, pop and iteration") {
+    auto arena = make_arena(6);
+    list_t list(arena.data());
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+
+    list.push_back(arena[2]);
+    list.push_back(arena[4]);
+    list.push_front(arena[0]);
+    list.insert(list.iterator_to(arena[4]), arena[3]);
+    CHECK(list.size() == 4);
+    CHECK(values(list) == std::vector<int>{0, 2, 3, 4});
+    CHECK(reverse_values(list) == std::vector<int>{4, 3, 2, 0});
+    CHECK(list.front().value == 0);
+    CHECK(list.back().value == 4);
+
+    list.pop_front();
+    list.pop_back();
+    CHECK(values(list) == std::vector<int>{2, 3});
+
+    auto it = list.erase(list.begin());
+    CHECK(it->value == 3);
+    CHECK(list.erase(it) == list.end());
+    CHECK(list.empty());
+}
+
+TEST_CASE("offset_list splice") {
+    auto arena = make_arena(8);
+    list_t a(arena.data());
+    list_t b(arena.data());
+    for (int i = 0; i < 4; ++i) {
+        a.push_back(arena[i]);
+        b.push_back(arena[i + 4]);
+    }
+
+    SECTION("whole list") {
+        a.splice(a.iterator_to(arena[2]), b);
+        CHECK(b.empty());
+        CHECK(a.size() == 8);
+        CHECK(values(a) == std::vector<int>{0, 1, 4, 5, 6, 7, 2, 3});
+        CHECK(reverse_values(a) == std::vector<int>{3, 2, 7, 6, 5, 4, 1, 0});
+    }
+
+    SECTION("one element between lists") {
+        a.splice(a.end(), b, b.iterator_to(arena[5]));
+        CHECK(values(a) == std::vector<int>{0, 1, 2, 3, 5});
+        CHECK(values(b) == std::vector<int>{4, 6, 7});
+        CHECK(a.size() == 5);
+        CHECK(b.size() == 3);
+    }
+
+    SECTION("one element within a list") {
+        a.splice(a.begin(), a, a.iterator_to(arena[3]));
+        CHECK(values(a) == std::vector<int>{3, 0, 1, 2});
+        CHECK(reverse_values(a) == std::vector<int>{2, 1, 0, 3});
+        CHECK(a.size() == 4);
+    }
+}
+
+TEST_CASE("offset_list move and swap") {
+    auto arena = make_arena(4);
+    list_t a(arena.data());
+    a.push_back(arena[1]);
+    a.push_back(arena[3]);
+
+    list_t b(std::move(a));
+    CHECK(a.empty());
+    CHECK(values(b) == std::vector<int>{1, 3});
+
+    list_t c(arena.data());
+    c.push_back(arena[0]);
+    c.swap(b);
+    CHECK(values(c) == std::vector<int>{1, 3});
+    CHECK(values(b) == std::vector<int>{0});
+
+    a = std::move(c);
+    CHECK(c.empty());
+    CHECK(values(a) == std::vector<int>{1, 3});
+    CHECK(reverse_values(a) == std::vector<int>{3, 1});
+
+    a.clear();
+    CHECK(a.empty());
+    CHECK(a.size() == 0);
+}
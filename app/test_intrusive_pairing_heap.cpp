@@ -0,0 +1,165 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <functional>
+#include <random>
+#include <ra/intrusive_pairing_heap.hpp>
+#include <set>
+#include <vector>
+
+struct task {
+    explicit task(int priority = 0) : priority(priority) {}
+    int priority;
+    ra::intrusive::pairing_heap_hook hook;
+
+    bool operator<(const task& other) const {
+        return priority < other.priority;
+    }
+    bool operator>(const task& other) const {
+        return priority > other.priority;
+    }
+};
+
+using heap_t = ra::intrusive::pairing_heap<task, &task::hook>;
+using min_heap_t = ra::intrusive::pairing_heap<task, &task::hook, std::greater<task>>;
+
+// Pops every element of the heap, returning the priorities in order.
+template <class Heap>
+std::vector<int> drain(Heap& heap) {
+    std::vector<int> result;
+    while (!heap.empty()) {
+        result.push_back(heap.top().priority);
+        heap.pop();
+    }
+    return result;
+}
+
+TEST_CASE("Hook is three pointers", "[pairing_heap]") {
+    CHECK(sizeof(ra::intrusive::pairing_heap_hook) == 3 * sizeof(void*));
+}
+
+TEST_CASE("Push, top and pop", "[pairing_heap]") {
+    heap_t heap;
+    CHECK(heap.empty());
+    CHECK(heap.size() == 0);
+
+    std::vector<task> tasks;
+    for (int p : {5, 1, 9, 3, 7, 9, 2}) {
+        tasks.emplace_back(p);
+    }
+    for (auto& t : tasks) {
+        heap.push(t);
+    }
+    CHECK(heap.size() == 7);
+    CHECK(heap.top().priority == 9);
+    CHECK(drain(heap) == std::vector<int>{9, 9, 7, 5, 3, 2, 1});
+    CHECK(heap.size() == 0);
+}
+
+TEST_CASE("Decrease key, erase and meld", "[pairing_heap]") {
+    min_heap_t heap;
+    std::vector<task> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.emplace_back(10 * i + 10);
+    }
+    for (auto& t : tasks) {
+        heap.push(t);
+    }
+
+    // Decrease-key on a min-heap.
+    tasks[7].priority = 5;
+    heap.increase(tasks[7]);
+    CHECK(&heap.top() == &tasks[7]);
+
+    // Arbitrary updates.
+    tasks[7].priority = 1000;
+    heap.update(tasks[7]);
+    CHECK(&heap.top() == &tasks[0]);
+
+    heap.erase(tasks[0]);
+    heap.erase(tasks[5]);
+    heap.erase(tasks[7]);
+    CHECK(heap.size() == 7);
+
+    min_heap_t other;
+    task a(15), b(25);
+    other.push(a);
+    other.push(b);
+    heap.meld(other);
+    CHECK(other.empty());
+    CHECK(heap.size() == 9);
+    CHECK(drain(heap) == std::vector<int>{15, 20, 25, 30, 40, 50, 70, 90, 100});
+}
+
+TEST_CASE("Move, swap and clear", "[pairing_heap]") {
+    task a(1), b(2), c(3);
+    heap_t x;
+    x.push(a);
+    x.push(b);
+
+    heap_t y(std::move(x));
+    CHECK(x.empty());
+    CHECK(y.size() == 2);
+
+    x.push(c);
+    x.swap(y);
+    CHECK(x.top().priority == 2);
+    CHECK(y.top().priority == 3);
+
+    y = std::move(x);
+    CHECK(x.empty());
+    CHECK(drain(y) == std::vector<int>{2, 1});
+
+    // Cleared elements may be pushed again.
+    x.push(a);
+    x.push(c);
+    x.clear();
+    CHECK(x.empty());
+    x.push(c);
+    x.push(a);
+    CHECK(drain(x) == std::vector<int>{3, 1});
+}
+
+TEST_CASE("Random operations match a multiset", "[pairing_heap]") {
+    constexpr int count = 2000;
+    std::vector<task> tasks(count);
+    std::vector<bool> in_heap(count, false);
+    std::multiset<int> reference;
+    heap_t heap;
+    std::mt19937 random(1);
+
+    for (int step = 0; step < 50000; ++step) {
+        int i = int(random() % count);
+        int op = int(random() % 4);
+        if (!in_heap[i]) {
+            tasks[i].priority = int(random() % 10000);
+            heap.push(tasks[i]);
+            reference.insert(tasks[i].priority);
+            in_heap[i] = true;
+        } else if (op == 0) {
+            reference.erase(reference.find(tasks[i].priority));
+            heap.erase(tasks[i]);
+            in_heap[i] = false;
+        } else if (op == 1) {
+            reference.erase(reference.find(tasks[i].priority));
+            tasks[i].priority += int(random() % 1000);
+            reference.insert(tasks[i].priority);
+            heap.increase(tasks[i]);
+        } else if (op == 2) {
+            reference.erase(reference.find(tasks[i].priority));
+            tasks[i].priority = int(random() % 10000);
+            reference.insert(tasks[i].priority);
+            heap.update(tasks[i]);
+        } else {
+            int top = heap.top().priority;
+            CHECK(top == *reference.rbegin());
+            task& t = heap.top();
+            heap.pop();
+            reference.erase(std::prev(reference.end()));
+            in_heap[&t - tasks.data()] = false;
+        }
+        REQUIRE(heap.size() == reference.size());
+    }
+
+    std::vector<int> expected(reference.rbegin(), reference.rend());
+    CHECK(drain(heap) == expected);
+}
@@ -0,0 +1,70 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_list.hpp>
+#include <ra/intrusive_prefetch.hpp>
+#include <ra/intrusive_slist.hpp>
+#include <vector>
+
+struct widget {
+    explicit widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::list_hook hook;
+    ra::intrusive::slist_hook slist_hook;
+};
+
+using list_t = ra::intrusive::list<widget, &widget::hook>;
+
+TEST_CASE("Prefetching traversal visits every element in order", "[prefetch]") {
+    std::vector<widget> widgets;
+    for (int i = 0; i < 10; ++i) {
+        widgets.emplace_back(i);
+    }
+    list_t list;
+    for (auto& w : widgets) {
+        list.push_back(w);
+    }
+
+    // Distances of zero, within the list and beyond its end.
+    for (std::size_t distance : {0, 1, 4, 10, 64}) {
+        std::vector<int> seen;
+        ra::intrusive::for_each_prefetch(list, [&](widget& w) { seen.push_back(w.value); }, distance, true);
+        CHECK(seen == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    }
+
+    list.clear();
+}
+
+TEST_CASE("Prefetching iterator adaptor", "[prefetch]") {
+    widget a(1), b(2), c(3);
+
+    SECTION("Empty list") {
+        const list_t list;
+        CHECK(ra::intrusive::prefetch_begin(list, 4) == ra::intrusive::prefetch_end(list));
+    }
+
+    SECTION("Mutation through the adaptor") {
+        list_t list;
+        list.push_back(a);
+        list.push_back(b);
+        list.push_back(c);
+
+        for (auto it = ra::intrusive::prefetch_begin(list, 2); it != ra::intrusive::prefetch_end(list); ++it) {
+            it->value *= 10;
+        }
+        CHECK(a.value == 10);
+        CHECK(b.value == 20);
+        CHECK(c.value == 30);
+        CHECK(&*ra::intrusive::prefetch_begin(list, 1).base() == &a);
+        list.clear();
+    }
+
+    SECTION("Forward-only containers") {
+        ra::intrusive::slist<widget, &widget::slist_hook> list;
+        list.push_back(a);
+        list.push_back(b);
+
+        int sum = 0;
+        ra::intrusive::for_each_prefetch(list, [&](const widget& w) { sum += w.value; }, 8);
+        CHECK(sum == 3);
+    }
+}
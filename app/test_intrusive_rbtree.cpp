@@ -0,0 +1,173 @@
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <ra/intrusive_rbtree.hpp>
+#include <set>
+#include <vector>
+
+struct item {
+    explicit item(int key) : key(key) {}
+    int key;
+    ra::intrusive::set_hook hook;
+};
+
+struct item_less {
+    bool operator()(const item& x, const item& y) const {
+        return x.key < y.key;
+    }
+    bool operator()(const item& x, int key) const {
+        return x.key < key;
+    }
+};
+
+using tree_t = ra::intrusive::rbtree<item, &item::hook, item_less>;
+
+std::vector<int> keys(const tree_t& tree) {
+    std::vector<int> result;
+    for (const auto& x : tree) {
+        result.push_back(x.key);
+    }
+    return result;
+}
+
+std::vector<int> reverse_keys(const tree_t& tree) {
+    std::vector<int> result;
+    for (auto it = tree.end(); it != tree.begin();) {
+        --it;
+        result.push_back(it->key);
+    }
+    return result;
+}
+
+TEST_CASE("set_hook is three pointers") {
+    CHECK(sizeof(ra::intrusive::set_hook) == 3 * sizeof(void*));
+}
+
+TEST_CASE("rbtree insert_unique and iteration") {
+    std::vector<item> items;
+    for (int k : {5, 3, 8, 1, 4, 7, 9, 2, 6}) {
+        items.emplace_back(k);
+    }
+    item duplicate(4);
+
+    tree_t tree;
+    CHECK(tree.empty());
+    CHECK(tree.begin() == tree.end());
+
+    for (auto& x : items) {
+        auto [it, inserted] = tree.insert_unique(x);
+        CHECK(inserted);
+        CHECK(&*it == &x);
+    }
+    auto [it, inserted] = tree.insert_unique(duplicate);
+    CHECK_FALSE(inserted);
+    CHECK(it->key == 4);
+    CHECK(&*it != &duplicate);
+
+    CHECK(tree.size() == 9);
+    CHECK(keys(tree) == std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+    CHECK(reverse_keys(tree) == std::vector<int>{9, 8, 7, 6, 5, 4, 3, 2, 1});
+
+    tree.clear();
+    CHECK(tree.empty());
+    CHECK(keys(tree).empty());
+}
+
+TEST_CASE("rbtree lower_bound and find") {
+    std::vector<item> items;
+    for (int k = 0; k < 10; ++k) {
+        items.emplace_back(2 * k);
+    }
+    tree_t tree;
+    for (auto& x : items) {
+        tree.insert_unique(x);
+    }
+
+    CHECK(tree.lower_bound(item(-1))->key == 0);
+    CHECK(tree.lower_bound(item(4))->key == 4);
+    CHECK(tree.lower_bound(item(5))->key == 6);
+    CHECK(tree.lower_bound(item(19)) == tree.end());
+    CHECK(tree.lower_bound(7, item_less())->key == 8);
+    CHECK(tree.find(item(6))->key == 6);
+    CHECK(tree.find(item(7)) == tree.end());
+
+    const tree_t& ctree = tree;
+    CHECK(ctree.lower_bound(11, item_less())->key == 12);
+    CHECK(ctree.find(item(18))->key == 18);
+    CHECK(&*ctree.iterator_to(items[3]) == &items[3]);
+    tree.clear();
+}
+
+TEST_CASE("rbtree erase") {
+    std::vector<item> items;
+    for (int k = 0; k < 8; ++k) {
+        items.emplace_back(k);
+    }
+    tree_t tree;
+    for (auto& x : items) {
+        tree.insert_unique(x);
+    }
+
+    auto it = tree.erase(tree.iterator_to(items[3]));
+    CHECK(it->key == 4);
+    tree.erase(items[0]);
+    it = tree.erase(tree.iterator_to(items[7]));
+    CHECK(it == tree.end());
+    CHECK(keys(tree) == std::vector<int>{1, 2, 4, 5, 6});
+    CHECK(reverse_keys(tree) == std::vector<int>{6, 5, 4, 2, 1});
+
+    // An erased element can be inserted again.
+    CHECK(tree.insert_unique(items[3]).second);
+    CHECK(keys(tree) == std::vector<int>{1, 2, 3, 4, 5, 6});
+
+    while (!tree.empty()) {
+        tree.erase(tree.begin());
+    }
+    CHECK(tree.begin() == tree.end());
+}
+
+TEST_CASE("rbtree random operations") {
+    constexpr int n = 2000;
+    std::vector<item> items;
+    items.reserve(n);
+    for (int k = 0; k < n; ++k) {
+        items.emplace_back(k);
+    }
+    std::vector<bool> linked(n, false);
+
+    tree_t tree;
+    std::set<int> expected;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, n - 1);
+
+    for (int i = 0; i < 20000; ++i) {
+        int k = dist(gen);
+        if (linked[k]) {
+            tree.erase(items[k]);
+            expected.erase(k);
+        } else {
+            CHECK(tree.insert_unique(items[k]).second);
+            expected.insert(k);
+        }
+        linked[k] = !linked[k];
+
+        if (i % 1000 == 0) {
+            CHECK(keys(tree) == std::vector<int>(expected.begin(), expected.end()));
+            CHECK(reverse_keys(tree) == std::vector<int>(expected.rbegin(), expected.rend()));
+        }
+    }
+
+    CHECK(tree.size() == expected.size());
+    CHECK(keys(tree) == std::vector<int>(expected.begin(), expected.end()));
+    for (int k = 0; k < n; k += 7) {
+        auto it = tree.lower_bound(k, item_less());
+        auto eit = expected.lower_bound(k);
+        if (eit == expected.end()) {
+            CHECK(it == tree.end());
+        } else {
+            CHECK(it->key == *eit);
+        }
+    }
+    tree.clear();
+}
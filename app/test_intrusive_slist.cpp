@@ -0,0 +1,181 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_slist.hpp>
+#include <vector>
+
+struct widget {
+    explicit widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::slist_hook hook;
+};
+
+template <class List>
+std::vector<int> values(const List& list) {
+    std::vector<int> result;
+    for (const auto& w : list) {
+        result.push_back(w.value);
+    }
+    return result;
+}
+
+TEST_CASE("Hook is a single pointer", "[slist]") {
+    CHECK(sizeof(ra::intrusive::slist_hook) == sizeof(void*));
+    CHECK(sizeof(ra::intrusive::slist<widget, &widget::hook, false>) <
+          sizeof(ra::intrusive::slist<widget, &widget::hook, true>));
+}
+
+TEST_CASE("Default constructor", "[slist]") {
+    ra::intrusive::slist<widget, &widget::hook> list;
+
+    CHECK(list.size() == 0);
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+}
+
+TEST_CASE("Push and pop", "[slist]") {
+    using slist_t = ra::intrusive::slist<widget, &widget::hook>;
+    widget a(1), b(2), c(3), d(4);
+    slist_t list;
+
+    SECTION("push_back keeps insertion order") {
+        list.push_back(a);
+        list.push_back(b);
+        list.push_back(c);
+
+        CHECK(list.size() == 3);
+        CHECK(values(list) == std::vector<int>{1, 2, 3});
+        CHECK(&list.front() == &a);
+        CHECK(&list.back() == &c);
+    }
+
+    SECTION("push_front reverses insertion order") {
+        list.push_front(a);
+        list.push_front(b);
+        list.push_front(c);
+
+        CHECK(values(list) == std::vector<int>{3, 2, 1});
+        CHECK(&list.back() == &a);
+    }
+
+    SECTION("Queue usage") {
+        list.push_back(a);
+        list.push_back(b);
+        list.pop_front();
+        list.push_back(c);
+        list.pop_front();
+        list.pop_front();
+
+        CHECK(list.empty());
+        CHECK(list.size() == 0);
+
+        // The cached tail is reset once the list becomes empty.
+        list.push_back(d);
+        CHECK(&list.front() == &d);
+        CHECK(&list.back() == &d);
+    }
+}
+
+TEST_CASE("Insert after and erase after", "[slist]") {
+    using slist_t = ra::intrusive::slist<widget, &widget::hook>;
+    widget a(1), b(2), c(3), d(4);
+    slist_t list;
+    list.push_back(a);
+    list.push_back(c);
+
+    auto it = list.insert_after(list.begin(), b);
+    CHECK(&*it == &b);
+    CHECK(values(list) == std::vector<int>{1, 2, 3});
+
+    it = list.erase_after(list.begin());
+    CHECK(&*it == &c);
+    CHECK(values(list) == std::vector<int>{1, 3});
+
+    // Erasing the last element updates the cached tail.
+    it = list.erase_after(list.begin());
+    CHECK(it == list.end());
+    CHECK(&list.back() == &a);
+
+    list.insert_after(list.begin(), d);
+    CHECK(&list.back() == &d);
+    CHECK(values(list) == std::vector<int>{1, 4});
+    CHECK(list.size() == 2);
+}
+
+TEST_CASE("List without a cached tail", "[slist]") {
+    using slist_t = ra::intrusive::slist<widget, &widget::hook, false>;
+    widget a(1), b(2), c(3);
+    slist_t list;
+
+    list.push_front(c);
+    list.push_front(b);
+    list.push_front(a);
+    CHECK(values(list) == std::vector<int>{1, 2, 3});
+
+    list.erase_after(list.begin());
+    CHECK(values(list) == std::vector<int>{1, 3});
+
+    list.clear();
+    CHECK(list.empty());
+}
+
+TEST_CASE("Move and swap", "[slist]") {
+    using slist_t = ra::intrusive::slist<widget, &widget::hook>;
+    widget a(1), b(2), c(3);
+
+    SECTION("Move construct") {
+        slist_t list;
+        list.push_back(a);
+        list.push_back(b);
+
+        slist_t list2(std::move(list));
+        CHECK(list.empty());
+        CHECK(values(list2) == std::vector<int>{1, 2});
+
+        list2.push_back(c);
+        CHECK(&list2.back() == &c);
+
+        // The moved-from list is still usable.
+        list2.pop_front();
+        list.push_back(a);
+        CHECK(&list.back() == &a);
+    }
+
+    SECTION("Swap with an empty list") {
+        slist_t list, list2;
+        list.push_back(a);
+
+        list.swap(list2);
+        CHECK(list.empty());
+        CHECK(list2.size() == 1);
+
+        list.push_back(b);
+        list2.push_back(c);
+        CHECK(values(list) == std::vector<int>{2});
+        CHECK(values(list2) == std::vector<int>{1, 3});
+    }
+}
+
+struct task : ra::intrusive::slist_hook {
+    explicit task(int value) : value(value) {}
+    int value;
+    ra::intrusive::slist_hook other_hook;
+};
+
+TEST_CASE("Hook selection", "[slist]") {
+    using base_slist_t = ra::intrusive::slist<task, ra::intrusive::base_hook<ra::intrusive::slist_hook>>;
+    using member_slist_t = ra::intrusive::slist<task, &task::other_hook>;
+    task a(1), b(2);
+    base_slist_t list;
+    member_slist_t list2;
+
+    list.push_back(a);
+    list.push_back(b);
+    list2.push_back(b);
+    list2.push_back(a);
+
+    CHECK(values(list) == std::vector<int>{1, 2});
+    CHECK(values(list2) == std::vector<int>{2, 1});
+
+    list.clear();
+    list2.clear();
+}
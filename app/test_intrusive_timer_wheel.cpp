@@ -0,0 +1,136 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <random>
+#include <ra/intrusive_timer_wheel.hpp>
+#include <vector>
+
+struct connection {
+    explicit connection(int id = 0) : id(id) {}
+    int id;
+    std::uint64_t deadline = 0;
+    std::uint64_t fired_at = 0;
+    ra::intrusive::basic_list_hook<ra::intrusive::link_mode::auto_unlink> timer_hook;
+};
+
+using wheel_t = ra::intrusive::timer_wheel<connection, &connection::timer_hook, &connection::deadline>;
+
+TEST_CASE("Arm, tick and cancel", "[timer_wheel]") {
+    wheel_t wheel(100);
+    connection a(1), b(2), c(3);
+    std::vector<int> fired;
+    auto record = [&](connection& x) { fired.push_back(x.id); };
+
+    wheel.arm(a, 102);
+    wheel.arm_after(b, 1);
+    wheel.arm(c, 102);
+    CHECK(wheel_t::armed(a));
+
+    CHECK(wheel.tick(record) == 1);
+    CHECK(wheel.now() == 101);
+    CHECK(fired == std::vector<int>{2});
+    CHECK(!wheel_t::armed(b));
+
+    wheel_t::cancel(c);
+    CHECK(!wheel_t::armed(c));
+    CHECK(wheel.tick(record) == 1);
+    CHECK(fired == std::vector<int>{2, 1});
+
+    // A timer in the past expires at the next tick.
+    wheel.arm(c, 50);
+    CHECK(wheel.tick(record) == 1);
+    CHECK(fired == std::vector<int>{2, 1, 3});
+}
+
+TEST_CASE("Rearming and destruction", "[timer_wheel]") {
+    wheel_t wheel;
+    connection a(1);
+    int fired = 0;
+
+    // A timer may be rearmed by its own callback.
+    wheel.arm(a, 10);
+    wheel.advance_to(100, [&](connection& x) {
+        ++fired;
+        wheel.arm_after(x, 10);
+    });
+    CHECK(fired == 10);
+    CHECK(a.deadline == 110);
+
+    // Rearming moves the timer.
+    wheel.arm(a, 1000);
+    CHECK(wheel.advance_to(999, [&](connection&) { ++fired; }) == 0);
+
+    // Destroying an armed timer cancels it.
+    {
+        connection b(2);
+        wheel.arm(b, 1001);
+    }
+    CHECK(wheel.advance_to(2000, [&](connection& x) { CHECK(&x == &a); }) == 1);
+}
+
+TEST_CASE("Every timer fires exactly at its deadline", "[timer_wheel]") {
+    constexpr int count = 200000;
+    const std::uint64_t start = 0xFFFF00 - 3;
+    wheel_t wheel(start);
+    std::vector<connection> timers(count);
+    std::mt19937_64 random(1);
+
+    for (int i = 0; i < count; ++i) {
+        timers[i].id = i;
+        // Spread the delays over all of the levels (and beyond).
+        int bits = 1 + i % 34;
+        wheel.arm_after(timers[i], random() & ((std::uint64_t(1) << bits) - 1));
+    }
+    std::vector<std::uint64_t> deadlines;
+    for (const auto& t : timers) {
+        deadlines.push_back(t.deadline);
+    }
+
+    // Jump to near a far deadline and check that nothing fires early.
+    std::uint64_t fired = 0;
+    auto on_expire = [&](connection& x) {
+        x.fired_at = wheel.now();
+        ++fired;
+    };
+    wheel.advance_to(start + (1 << 20), on_expire);
+    for (int i = 0; i < count; ++i) {
+        if (timers[i].deadline <= start + (1 << 20)) {
+            CHECK(timers[i].fired_at == deadlines[i]);
+        } else {
+            CHECK(wheel_t::armed(timers[i]));
+        }
+    }
+
+    // Cancel the timers that are out of reach of this test.
+    for (auto& t : timers) {
+        if (t.deadline > start + (1 << 20)) {
+            wheel_t::cancel(t);
+            ++fired;
+        }
+    }
+    CHECK(fired == count);
+}
+
+TEST_CASE("Timers beyond the range of the wheel", "[timer_wheel]") {
+    // A wheel of two levels of 16 slots covers 256 ticks.
+    ra::intrusive::timer_wheel<connection, &connection::timer_hook, &connection::deadline, 4, 2> wheel;
+    using small_wheel_t = decltype(wheel);
+    connection a(1);
+    const std::uint64_t far = 3 * 256 + 5;
+
+    wheel.arm(a, far);
+    CHECK(a.deadline == far);
+
+    // Skip ahead by cascading alone (no timer is due in between).
+    std::uint64_t fired_at = 0;
+    while (wheel.now() < far + 1) {
+        wheel.tick([&](connection&) { fired_at = wheel.now(); });
+        if (wheel.now() == far - 3) {
+            CHECK(small_wheel_t::armed(a));
+        }
+        if (fired_at) {
+            break;
+        }
+    }
+    CHECK(fired_at == far);
+}
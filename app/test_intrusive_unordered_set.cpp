@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_unordered_set.hpp>
+#include <set>
+#include <vector>
+
+template <class Hook>
+struct basic_item {
+    explicit basic_item(int key) : key(key) {}
+    int key;
+    Hook hook;
+};
+
+struct item_hash {
+    template <class Item>
+    std::size_t operator()(const Item& x) const {
+        return std::hash<int>()(x.key);
+    }
+    std::size_t operator()(int key) const {
+        return std::hash<int>()(key);
+    }
+};
+
+struct item_equal {
+    template <class Item>
+    bool operator()(const Item& x, const Item& y) const {
+        return x.key == y.key;
+    }
+    template <class Item>
+    bool operator()(int key, const Item& y) const {
+        return key == y.key;
+    }
+};
+
+template <class Set>
+std::multiset<int> keys(const Set& set) {
+    std::multiset<int> result;
+    for (const auto& x : set) {
+        result.insert(x.key);
+    }
+    return result;
+}
+
+TEMPLATE_TEST_CASE("Insert, find and erase", "[unordered_set]", ra::intrusive::basic_unordered_set_hook<false>,
+                   ra::intrusive::basic_unordered_set_hook<true>) {
+    using item = basic_item<TestType>;
+    using set_t = ra::intrusive::unordered_set<item, &item::hook, item_hash, item_equal>;
+
+    set_t set(4);
+    item a(1), b(2), b2(2);
+
+    CHECK(set.empty());
+    CHECK(set.begin() == set.end());
+    CHECK(set.bucket_count() == 4);
+
+    auto [it, inserted] = set.insert(a);
+    CHECK(inserted);
+    CHECK(&*it == &a);
+    CHECK(set.insert(b).second);
+    CHECK(set.insert(b2) == std::make_pair(set.find(b), false));
+    CHECK(set.size() == 2);
+
+    CHECK(&*set.find(b2) == &b);
+    CHECK(&*set.find(1, item_hash(), item_equal()) == &a);
+    CHECK(set.find(3, item_hash(), item_equal()) == set.end());
+    CHECK(set.count(a) == 1);
+    CHECK(keys(set) == std::multiset<int>{1, 2});
+
+    set.erase(a);
+    CHECK(set.find(a) == set.end());
+    CHECK(set.size() == 1);
+
+    set.clear();
+    CHECK(set.empty());
+    CHECK(set.begin() == set.end());
+}
+
+TEMPLATE_TEST_CASE("Incremental growth", "[unordered_set]", ra::intrusive::basic_unordered_set_hook<false>,
+                   ra::intrusive::basic_unordered_set_hook<true>) {
+    using item = basic_item<TestType>;
+    using set_t = ra::intrusive::unordered_set<item, &item::hook, item_hash, item_equal>;
+
+    std::vector<item> items;
+    for (int i = 0; i < 1000; ++i) {
+        items.emplace_back(i * 3);
+    }
+
+    set_t set(2);
+    bool rehashed = false;
+    bool found = true;
+    std::size_t max_bucket_count_jump = 0;
+    for (int i = 0; i < 1000; ++i) {
+        std::size_t before = set.bucket_count();
+        set.insert(items[i]);
+        max_bucket_count_jump = std::max(max_bucket_count_jump, set.bucket_count() / before);
+        rehashed = rehashed || set.rehashing();
+
+        // Every element is found while a rehash is in progress.
+        if (set.rehashing()) {
+            for (int j = 0; j <= i; ++j) {
+                found = found && &*set.find(j * 3, item_hash(), item_equal()) == &items[j];
+            }
+        }
+    }
+
+    CHECK(rehashed);
+    CHECK(found);
+    CHECK(max_bucket_count_jump == 2);
+    CHECK(set.size() == 1000);
+    CHECK(set.load_factor() <= 1.0f);
+    CHECK(keys(set).size() == 1000);
+
+    for (int i = 0; i < 1000; i += 2) {
+        set.erase(items[i]);
+    }
+    CHECK(set.size() == 500);
+    for (int i = 0; i < 1000; ++i) {
+        CHECK((set.find(items[i]) != set.end()) == (i % 2 == 1));
+    }
+}
+
+TEST_CASE("User-provided buckets", "[unordered_set]") {
+    using item = basic_item<ra::intrusive::unordered_set_hook>;
+    using set_t = ra::intrusive::unordered_set<item, &item::hook, item_hash, item_equal>;
+
+    set_t::bucket_type buckets[4] = {};
+    set_t::bucket_type bigger[16] = {};
+    std::vector<item> items;
+    for (int i = 0; i < 20; ++i) {
+        items.emplace_back(i);
+    }
+
+    set_t set(buckets, 4);
+    for (auto& x : items) {
+        set.insert(x);
+    }
+
+    // The set never replaces user-provided buckets on its own.
+    CHECK(set.bucket_count() == 4);
+    CHECK(!set.rehashing());
+    CHECK(set.size() == 20);
+
+    set.rehash(bigger, 16);
+    CHECK(set.rehashing());
+    CHECK(set.bucket_count() == 16);
+    CHECK(keys(set).size() == 20);
+
+    // Each erase migrates a few old buckets.
+    set.erase(items[0]);
+    set.erase(items[1]);
+    CHECK(!set.rehashing());
+    for (auto& b : buckets) {
+        CHECK(b.head == nullptr);
+    }
+    CHECK(set.size() == 18);
+    CHECK(&*set.find(items[7]) == &items[7]);
+
+    set.clear();
+}
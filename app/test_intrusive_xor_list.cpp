@@ -0,0 +1,155 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/intrusive_xor_list.hpp>
+#include <vector>
+
+struct widget {
+    explicit widget(int value) : value(value) {}
+    int value;
+    ra::intrusive::xor_list_hook hook;
+};
+
+using xor_list_t = ra::intrusive::xor_list<widget, &widget::hook>;
+
+std::vector<int> values(const xor_list_t& list) {
+    std::vector<int> result;
+    for (const auto& w : list) {
+        result.push_back(w.value);
+    }
+    return result;
+}
+
+std::vector<int> reverse_values(const xor_list_t& list) {
+    std::vector<int> result;
+    for (auto it = list.end(); it != list.begin();) {
+        --it;
+        result.push_back(it->value);
+    }
+    return result;
+}
+
+TEST_CASE("Hook is a single word", "[xor_list]") {
+    CHECK(sizeof(ra::intrusive::xor_list_hook) == sizeof(void*));
+}
+
+TEST_CASE("Default constructor", "[xor_list]") {
+    xor_list_t list;
+
+    CHECK(list.size() == 0);
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+}
+
+TEST_CASE("Push and pop at both ends", "[xor_list]") {
+    widget a(1), b(2), c(3), d(4);
+    xor_list_t list;
+
+    list.push_back(b);
+    list.push_back(c);
+    list.push_front(a);
+    list.push_back(d);
+
+    CHECK(list.size() == 4);
+    CHECK(values(list) == std::vector<int>{1, 2, 3, 4});
+    CHECK(reverse_values(list) == std::vector<int>{4, 3, 2, 1});
+    CHECK(&list.front() == &a);
+    CHECK(&list.back() == &d);
+
+    list.pop_front();
+    list.pop_back();
+    CHECK(values(list) == std::vector<int>{2, 3});
+    CHECK(reverse_values(list) == std::vector<int>{3, 2});
+
+    list.pop_back();
+    list.pop_back();
+    CHECK(list.empty());
+    CHECK(list.begin() == list.end());
+
+    list.push_front(d);
+    CHECK(&list.front() == &d);
+    CHECK(&list.back() == &d);
+}
+
+TEST_CASE("Insert and erase by iterator", "[xor_list]") {
+    widget a(1), b(2), c(3), d(4);
+    xor_list_t list;
+    list.push_back(a);
+    list.push_back(c);
+
+    auto it = list.insert(std::next(list.begin()), b);
+    CHECK(it->value == 2);
+    CHECK(values(list) == std::vector<int>{1, 2, 3});
+    CHECK(reverse_values(list) == std::vector<int>{3, 2, 1});
+
+    it = list.erase(list.begin());
+    CHECK(&*it == &b);
+    it = list.erase(it);
+    CHECK(&*it == &c);
+    list.insert(it, d);
+    CHECK(values(list) == std::vector<int>{4, 3});
+    CHECK(reverse_values(list) == std::vector<int>{3, 4});
+}
+
+TEST_CASE("Splice whole lists", "[xor_list]") {
+    widget a(1), b(2), c(3), d(4), e(5);
+    xor_list_t x, y;
+    x.push_back(a);
+    x.push_back(b);
+    y.push_back(c);
+    y.push_back(d);
+
+    SECTION("At the end") {
+        x.splice(x.end(), y);
+        CHECK(y.empty());
+        CHECK(x.size() == 4);
+        CHECK(values(x) == std::vector<int>{1, 2, 3, 4});
+        CHECK(reverse_values(x) == std::vector<int>{4, 3, 2, 1});
+    }
+
+    SECTION("At the beginning") {
+        x.splice(x.begin(), y);
+        CHECK(values(x) == std::vector<int>{3, 4, 1, 2});
+        CHECK(reverse_values(x) == std::vector<int>{2, 1, 4, 3});
+    }
+
+    SECTION("In the middle") {
+        x.splice(std::next(x.begin()), y);
+        CHECK(values(x) == std::vector<int>{1, 3, 4, 2});
+        CHECK(reverse_values(x) == std::vector<int>{2, 4, 3, 1});
+    }
+
+    SECTION("Into an empty list") {
+        xor_list_t z;
+        z.splice(z.end(), x);
+        CHECK(x.empty());
+        CHECK(values(z) == std::vector<int>{1, 2});
+        z.push_back(e);
+        CHECK(reverse_values(z) == std::vector<int>{5, 2, 1});
+    }
+}
+
+TEST_CASE("Reverse, move and swap", "[xor_list]") {
+    widget a(1), b(2), c(3);
+    xor_list_t x;
+    x.push_back(a);
+    x.push_back(b);
+    x.push_back(c);
+
+    x.reverse();
+    CHECK(values(x) == std::vector<int>{3, 2, 1});
+    x.pop_front();
+    x.push_front(c);
+    CHECK(values(x) == std::vector<int>{3, 2, 1});
+
+    xor_list_t y(std::move(x));
+    CHECK(x.empty());
+    CHECK(values(y) == std::vector<int>{3, 2, 1});
+
+    x.swap(y);
+    CHECK(y.empty());
+    CHECK(reverse_values(x) == std::vector<int>{1, 2, 3});
+
+    y = std::move(x);
+    CHECK(x.empty());
+    CHECK(y.size() == 3);
+}
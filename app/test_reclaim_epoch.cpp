@@ -0,0 +1,177 @@
+#define CATCH_CONFIG_MAIN
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <ra/intrusive_atomic_stack.hpp>
+#include <ra/reclaim_epoch.hpp>
+#include <thread>
+#include <vector>
+
+std::atomic<int> live{0};
+
+struct node {
+    explicit node(int value = 0) : value(value) {
+        ++live;
+    }
+    ~node() {
+        --live;
+    }
+    int value;
+    ra::intrusive::atomic_stack_hook stack_hook;
+    ra::reclaim::retire_hook retire_hook;
+};
+
+using domain_t = ra::reclaim::epoch_domain;
+
+TEST_CASE("Pin and unpin", "[epoch]") {
+    domain_t domain;
+    domain_t::participant p(domain);
+
+    CHECK(!p.pinned());
+    {
+        domain_t::guard g(p);
+        CHECK(p.pinned());
+        {
+            domain_t::guard nested(p);
+            CHECK(p.pinned());
+        }
+        CHECK(p.pinned());
+    }
+    CHECK(!p.pinned());
+}
+
+TEST_CASE("Epoch advance", "[epoch]") {
+    domain_t domain;
+    domain_t::participant a(domain);
+    domain_t::participant b(domain);
+
+    auto e = domain.epoch();
+    CHECK(domain.try_advance());
+    CHECK(domain.epoch() == e + 1);
+
+    // A participant pinned in the current epoch allows one advance, after
+    // which it holds the epoch back.
+    a.pin();
+    CHECK(domain.try_advance());
+    CHECK(!domain.try_advance());
+    CHECK(domain.epoch() == e + 2);
+
+    a.unpin();
+    CHECK(domain.try_advance());
+    CHECK(domain.epoch() == e + 3);
+}
+
+TEST_CASE("Deferred disposal", "[epoch]") {
+    live = 0;
+    {
+        domain_t domain(1000);
+        domain_t::participant reader(domain);
+        domain_t::participant writer(domain);
+
+        node* x = new node(1);
+        reader.pin();
+        writer.retire<&node::retire_hook>(*x);
+        CHECK(writer.retired_count() == 1);
+
+        // The reader may still hold x.
+        for (int i = 0; i < 4; ++i) {
+            CHECK(writer.collect() == 0);
+        }
+        CHECK(live == 1);
+        CHECK(x->value == 1);
+
+        reader.unpin();
+        CHECK(writer.collect() + writer.collect() == 1);
+        CHECK(writer.retired_count() == 0);
+        CHECK(live == 0);
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("Batched retirement", "[epoch]") {
+    live = 0;
+    {
+        domain_t domain(8);
+        domain_t::participant p(domain);
+        CHECK(domain.batch_size() == 8);
+
+        for (int i = 0; i < 7; ++i) {
+            p.retire<&node::retire_hook>(*new node(i));
+        }
+        CHECK(p.retired_count() == 7);
+
+        // The limbo list is reclaimed in batches, so it never grows far
+        // beyond the batch size.
+        for (int i = 0; i < 1000; ++i) {
+            p.retire<&node::retire_hook>(*new node(i));
+            CHECK(p.retired_count() <= 3 * 8);
+        }
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("Custom disposer", "[epoch]") {
+    struct recycle {
+        void operator()(node* x) const {
+            x->value = -1;
+        }
+    };
+
+    domain_t domain;
+    node x(1);
+    {
+        domain_t::participant p(domain);
+        p.retire<&node::retire_hook, recycle>(x);
+    }
+    // The objects of a destroyed participant are left to the domain.
+    CHECK(x.value == 1);
+    domain.try_advance();
+    domain.try_advance();
+    CHECK(x.value == -1);
+}
+
+TEST_CASE("Concurrent stack", "[epoch]") {
+    constexpr int threads = 8;
+    constexpr int rounds = 20000;
+
+    live = 0;
+    {
+        domain_t domain;
+        ra::intrusive::atomic_stack<node, &node::stack_hook> stack;
+        for (int i = 0; i < 64; ++i) {
+            stack.push(*new node(i));
+        }
+
+        // Each thread pops nodes and retires them, and pushes new ones. A pop
+        // may read the hook of a node that another thread has just popped,
+        // which is safe since that node is not freed while the pop is pinned.
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                domain_t::participant p(domain);
+                for (int i = 0; i < rounds; ++i) {
+                    node* x;
+                    {
+                        domain_t::guard g(p);
+                        x = stack.pop();
+                    }
+                    if (x) {
+                        CHECK(x->value >= 0);
+                        p.retire<&node::retire_hook>(*x);
+                    }
+                    stack.push(*new node(i));
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+
+        int remaining = 0;
+        stack.pop_all([&](node& x) {
+            delete &x;
+            ++remaining;
+        });
+        CHECK(remaining == 64);
+    }
+    CHECK(live == 0);
+}
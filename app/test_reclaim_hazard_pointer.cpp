@@ -0,0 +1,146 @@
+#define CATCH_CONFIG_MAIN
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <ra/reclaim_hazard_pointer.hpp>
+#include <thread>
+#include <vector>
+
+std::atomic<int> live{0};
+
+struct node {
+    explicit node(int value = 0) : value(value) {
+        ++live;
+    }
+    ~node() {
+        --live;
+        value = -1;
+    }
+    int value;
+    ra::reclaim::retire_hook retire_hook;
+};
+
+using domain_t = ra::reclaim::hazard_domain<2>;
+
+TEST_CASE("Protect", "[hazard_pointer]") {
+    live = 0;
+    {
+        domain_t domain(1000);
+        domain_t::participant reader(domain);
+        domain_t::participant writer(domain);
+
+        std::atomic<node*> shared{new node(1)};
+        node* x = reader.protect(0, shared);
+        CHECK(x == shared.load());
+
+        // Replace the shared node; the old one stays protected.
+        writer.retire<&node::retire_hook>(*shared.exchange(new node(2)));
+        CHECK(writer.collect() == 0);
+        CHECK(writer.retired_count() == 1);
+        CHECK(x->value == 1);
+
+        // Protecting another object in another slot leaves x protected.
+        CHECK(reader.protect(1, shared) != x);
+        reader.clear(1);
+        CHECK(writer.collect() == 0);
+
+        reader.clear();
+        CHECK(writer.collect() == 1);
+        CHECK(writer.retired_count() == 0);
+        CHECK(live == 1);
+
+        delete shared.load();
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("Bounded retirement", "[hazard_pointer]") {
+    live = 0;
+    {
+        domain_t domain(4);
+        domain_t::participant reader(domain);
+        domain_t::participant writer(domain);
+        CHECK(domain.batch_size() == 4);
+
+        std::atomic<node*> shared{new node(0)};
+        reader.protect(0, shared);
+
+        // Only the protected node is held back, however many are retired.
+        for (int i = 1; i <= 1000; ++i) {
+            writer.retire<&node::retire_hook>(*shared.exchange(new node(i)));
+            CHECK(writer.retired_count() <= 4 + domain_t::slots * 2);
+        }
+        CHECK(live <= 1 + 1 + 4);
+
+        delete shared.load();
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("Orphaned objects", "[hazard_pointer]") {
+    live = 0;
+    {
+        domain_t domain;
+        domain_t::participant reader(domain);
+
+        std::atomic<node*> shared{new node(1)};
+        node* x = reader.protect(0, shared);
+        {
+            domain_t::participant writer(domain);
+            writer.retire<&node::retire_hook>(*shared.exchange(nullptr));
+        }
+
+        // The object of the destroyed writer is reclaimed by a later scan.
+        CHECK(reader.collect() == 0);
+        CHECK(x->value == 1);
+        reader.clear(0);
+        CHECK(reader.collect() == 1);
+        CHECK(live == 0);
+    }
+    CHECK(live == 0);
+}
+
+TEST_CASE("Concurrent replacement", "[hazard_pointer]") {
+    constexpr int readers = 4;
+    constexpr int writers = 4;
+    constexpr int rounds = 20000;
+
+    live = 0;
+    {
+        domain_t domain(16);
+        std::atomic<node*> shared{new node(0)};
+        std::atomic<bool> done{false};
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < readers; ++t) {
+            threads.emplace_back([&] {
+                domain_t::participant p(domain);
+                bool ok = true;
+                while (!done.load(std::memory_order_relaxed)) {
+                    node* x = p.protect(0, shared);
+                    ok = ok && x->value >= 0;
+                    p.clear(0);
+                }
+                CHECK(ok);
+            });
+        }
+        std::vector<std::thread> updaters;
+        for (int t = 0; t < writers; ++t) {
+            updaters.emplace_back([&] {
+                domain_t::participant p(domain);
+                for (int i = 1; i <= rounds; ++i) {
+                    p.retire<&node::retire_hook>(*shared.exchange(new node(i)));
+                }
+            });
+        }
+        for (auto& u : updaters) {
+            u.join();
+        }
+        done = true;
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        delete shared.load();
+    }
+    CHECK(live == 0);
+}
@@ -0,0 +1,163 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <ra/shm_sv_set.hpp>
+#include <ra/sv_set.hpp>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    // Returns a shared memory object name unique to this test run.
+    std::string unique_name(const char* tag) {
+        return "/ra_test_shm_sv_set_" + std::to_string(::getpid()) + "_" + tag;
+    }
+
+    // Runs f in a child process, and returns its exit status.
+    template <class F>
+    int in_child(F f) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            int status = 1;
+            try {
+                status = f();
+            } catch (...) {
+            }
+            ::_exit(status);
+        }
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+}  // namespace
+
+TEST_CASE("Image in a memory file", "[shm_sv_set]") {
+    using set_type = ra::container::shm_sv_set<int>;
+
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(3 * i);
+    }
+    int fd = set_type::make_memfd("test", set_type::ordered_and_unique_range(), keys.begin(), keys.size());
+
+    set_type s(fd);
+    CHECK(s.size() == keys.size());
+    CHECK(std::equal(s.begin(), s.end(), keys.begin(), keys.end()));
+    CHECK(s.contains(0));
+    CHECK(s.contains(2997));
+    CHECK(!s.contains(1));
+    CHECK(!s.contains(3000));
+    CHECK(s.find(-1) == s.end());
+    CHECK(*s.find(300) == 300);
+
+    // The file is sealed against changes.
+    CHECK(::ftruncate(fd, 0) != 0);
+
+    // A child process (as in a pre-fork model) maps the same image.
+    CHECK(in_child([fd] {
+              set_type child(fd);
+              return child.size() == 1000 && child.contains(2997) && !child.contains(2998) ? 0 : 1;
+          }) == 0);
+
+    // An image of another key type is rejected.
+    CHECK_THROWS_AS(ra::container::shm_sv_set<char>(fd), std::runtime_error);
+    ::close(fd);
+
+    set_type moved(std::move(s));
+    CHECK(s.empty());
+    CHECK(moved.size() == 1000);
+    CHECK(moved.contains(300));
+}
+
+TEST_CASE("Empty image", "[shm_sv_set]") {
+    using set_type = ra::container::shm_sv_set<double, std::greater<double>>;
+
+    ra::container::sv_set<double, std::greater<double>> empty;
+    int fd = set_type::make_memfd("empty", empty);
+    set_type s(fd);
+    ::close(fd);
+    CHECK(s.empty());
+    CHECK(s.begin() == s.end());
+    CHECK(!s.contains(1.0));
+}
+
+TEST_CASE("Publish and swap versions", "[shm_sv_set]") {
+    using set_type = ra::container::shm_sv_set<long>;
+    using sv_set_type = ra::container::sv_set<long>;
+
+    std::string name = unique_name("publish");
+    ra::container::shm_sv_set_publisher<long> publisher(name);
+    ra::container::shm_sv_set_subscriber<long> subscriber(name);
+
+    CHECK(publisher.generation() == 0);
+    CHECK(subscriber.current() == nullptr);
+
+    std::vector<long> v1{1, 2, 3};
+    CHECK(publisher.publish(sv_set_type(sv_set_type::ordered_and_unique_range(), v1.begin(), v1.size())) == 1);
+    std::shared_ptr<const set_type> s1 = subscriber.current();
+    REQUIRE(s1);
+    CHECK(s1->generation() == 1);
+    CHECK(std::equal(s1->begin(), s1->end(), v1.begin(), v1.end()));
+    // No new version, so the same snapshot is returned.
+    CHECK(subscriber.current() == s1);
+
+    std::vector<long> v2{10, 20, 30, 40};
+    CHECK(publisher.publish(set_type::ordered_and_unique_range(), v2.begin(), v2.size()) == 2);
+    std::shared_ptr<const set_type> s2 = subscriber.current();
+    REQUIRE(s2);
+    CHECK(s2->generation() == 2);
+    CHECK(std::equal(s2->begin(), s2->end(), v2.begin(), v2.end()));
+    // The old snapshot stays valid while it is held.
+    CHECK(std::equal(s1->begin(), s1->end(), v1.begin(), v1.end()));
+
+    // Worker processes pick up the current version, and then the next one,
+    // without restarting.
+    int pipe_fds[2];
+    REQUIRE(::pipe(pipe_fds) == 0);
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        int status = 1;
+        try {
+            ra::container::shm_sv_set_subscriber<long> worker(name);
+            std::shared_ptr<const set_type> s = worker.current();
+            bool ok = s && s->generation() == 2 && s->contains(40) && !s->contains(3);
+            ok = ok && ::write(pipe_fds[1], "r", 1) == 1;
+            // Wait for the parent to publish the next version.
+            while (ok && worker.published_generation() != 3) {
+                ::usleep(1000);
+            }
+            s = worker.current();
+            ok = ok && s->generation() == 3 && s->size() == 100 && s->contains(198) && !s->contains(200);
+            status = ok ? 0 : 1;
+        } catch (...) {
+        }
+        ::_exit(status);
+    }
+    char c;
+    REQUIRE(::read(pipe_fds[0], &c, 1) == 1);
+    std::vector<long> v3;
+    for (long i = 0; i < 100; ++i) {
+        v3.push_back(2 * i);
+    }
+    CHECK(publisher.publish(set_type::ordered_and_unique_range(), v3.begin(), v3.size()) == 3);
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+
+    CHECK(subscriber.current()->generation() == 3);
+}
+
+TEST_CASE("Publisher errors", "[shm_sv_set]") {
+    std::string name = unique_name("errors");
+    CHECK_THROWS_AS(ra::container::shm_sv_set_subscriber<int>(name), std::system_error);
+    {
+        ra::container::shm_sv_set_publisher<int> publisher(name);
+        // The name is taken while the publisher exists.
+        CHECK_THROWS_AS(ra::container::shm_sv_set_publisher<int>(name), std::system_error);
+    }
+    // The names are unlinked with the publisher.
+    CHECK_THROWS_AS(ra::container::shm_sv_set_subscriber<int>(name), std::system_error);
+}
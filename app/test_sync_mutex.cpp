@@ -0,0 +1,150 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <mutex>
+#include <ra/sync_condition_variable.hpp>
+#include <ra/sync_mutex.hpp>
+#include <thread>
+#include <vector>
+
+TEMPLATE_TEST_CASE("Lock and unlock", "[mutex]", ra::sync::mutex, ra::sync::fair_mutex) {
+    TestType m;
+
+    CHECK(m.try_lock());
+    CHECK(!m.try_lock());
+    m.unlock();
+
+    {
+        std::lock_guard<TestType> lock(m);
+        CHECK(!m.try_lock());
+    }
+    CHECK(m.try_lock());
+    m.unlock();
+}
+
+TEMPLATE_TEST_CASE("Mutual exclusion", "[mutex]", ra::sync::mutex, ra::sync::fair_mutex) {
+    constexpr int threads = 8;
+    constexpr int rounds = 20000;
+
+    TestType m;
+    long counter = 0;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < rounds; ++i) {
+                std::lock_guard<TestType> lock(m);
+                ++counter;
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    CHECK(counter == long(threads) * rounds);
+}
+
+TEST_CASE("FIFO handoff", "[mutex]") {
+    ra::sync::fair_mutex m;
+    std::vector<int> order;
+
+    m.lock();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            std::lock_guard<ra::sync::fair_mutex> lock(m);
+            order.push_back(t);
+        });
+        // Let the thread queue up behind the previous ones.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    // A newcomer cannot take the mutex away from the waiters.
+    m.unlock();
+    {
+        std::lock_guard<ra::sync::fair_mutex> lock(m);
+        order.push_back(-1);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    CHECK(order == std::vector<int>{0, 1, 2, 3, -1});
+}
+
+TEST_CASE("Condition variable", "[condition_variable]") {
+    ra::sync::mutex m;
+    ra::sync::condition_variable cv;
+
+    CHECK(cv.notify(1) == 0);
+    CHECK(cv.notify_all() == 0);
+
+    SECTION("Producer and consumer") {
+        std::vector<int> queue;
+        bool done = false;
+        long sum = 0;
+
+        std::thread consumer([&] {
+            std::unique_lock<ra::sync::mutex> lock(m);
+            for (;;) {
+                cv.wait(lock, [&] { return !queue.empty() || done; });
+                if (queue.empty()) {
+                    break;
+                }
+                sum += queue.back();
+                queue.pop_back();
+            }
+        });
+
+        for (int i = 1; i <= 1000; ++i) {
+            {
+                std::lock_guard<ra::sync::mutex> lock(m);
+                queue.push_back(i);
+            }
+            cv.notify_one();
+        }
+        {
+            std::lock_guard<ra::sync::mutex> lock(m);
+            done = true;
+        }
+        cv.notify_one();
+        consumer.join();
+        CHECK(sum == 1000 * 1001 / 2);
+    }
+
+    SECTION("Wake N") {
+        int ready = 0;
+        int released = 0;
+        int woken = 0;
+
+        std::vector<std::thread> waiters;
+        for (int t = 0; t < 5; ++t) {
+            waiters.emplace_back([&] {
+                std::unique_lock<ra::sync::mutex> lock(m);
+                ++ready;
+                cv.wait(lock, [&] { return released > 0; });
+                --released;
+                ++woken;
+            });
+        }
+        for (;;) {
+            std::lock_guard<ra::sync::mutex> lock(m);
+            if (ready == 5) {
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<ra::sync::mutex> lock(m);
+            released = 3;
+        }
+        CHECK(cv.notify(3) == 3);
+        {
+            std::lock_guard<ra::sync::mutex> lock(m);
+            released += 2;
+        }
+        cv.notify_all();
+        for (auto& w : waiters) {
+            w.join();
+        }
+        CHECK(woken == 5);
+    }
+}
@@ -0,0 +1,107 @@
+#define CATCH_CONFIG_MAIN
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <ra/sync_latch.hpp>
+#include <ra/sync_semaphore.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Acquire and release", "[semaphore]") {
+    ra::sync::counting_semaphore s(2);
+
+    CHECK(s.available() == 2);
+    s.acquire();
+    CHECK(s.try_acquire());
+    CHECK(!s.try_acquire());
+    CHECK(s.available() == 0);
+
+    s.release(3);
+    CHECK(s.available() == 3);
+}
+
+TEST_CASE("Bounded concurrency", "[semaphore]") {
+    constexpr int threads = 8;
+    constexpr int permits = 3;
+
+    ra::sync::counting_semaphore s(permits);
+    std::atomic<int> inside{0};
+    std::atomic<int> most{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) {
+                s.acquire();
+                int n = ++inside;
+                int m = most.load();
+                while (n > m && !most.compare_exchange_weak(m, n)) {
+                }
+                --inside;
+                s.release();
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    CHECK(most <= permits);
+    CHECK(s.available() == permits);
+}
+
+TEST_CASE("Release wakes N waiters", "[semaphore]") {
+    ra::sync::counting_semaphore s(0);
+    std::atomic<int> acquired{0};
+
+    std::vector<std::thread> waiters;
+    for (int t = 0; t < 6; ++t) {
+        waiters.emplace_back([&] {
+            s.acquire();
+            ++acquired;
+        });
+    }
+
+    s.release(4);
+    while (acquired < 4) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(acquired == 4);
+
+    s.release(2);
+    for (auto& w : waiters) {
+        w.join();
+    }
+    CHECK(acquired == 6);
+    CHECK(s.available() == 0);
+}
+
+TEST_CASE("Latch", "[latch]") {
+    ra::sync::latch zero(0);
+    CHECK(zero.try_wait());
+    zero.wait();
+
+    constexpr int threads = 6;
+    ra::sync::latch start(threads);
+    ra::sync::latch done(threads);
+    std::atomic<int> arrived{0};
+    std::atomic<bool> early{false};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            ++arrived;
+            start.arrive_and_wait();
+            // Every thread has arrived before any passes the latch.
+            if (arrived != threads) {
+                early = true;
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    CHECK(done.try_wait());
+    for (auto& w : workers) {
+        w.join();
+    }
+    CHECK(!early);
+}
@@ -0,0 +1,346 @@
+#ifndef ra_exec_scheduler_hpp
+#define ra_exec_scheduler_hpp
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ra/exec_task.hpp>
+#include <ra/intrusive_list.hpp>
+#include <ra/sync_futex.hpp>
+#include <ra/sync_spinlock.hpp>
+#include <thread>
+#include <type_traits>
+
+namespace ra::exec {
+    // Work-stealing coroutine scheduler.
+    //
+    // The scheduler runs tasks (see task) on a fixed set of worker threads.
+    // Each worker has a run queue of ready tasks, an intrusive deque linked
+    // through the hook embedded in each coroutine frame, so making a task
+    // ready never allocates memory. A worker runs the most recently queued
+    // task of its own deque first (which keeps the data of a fork hot in its
+    // cache), and when its deque is empty it steals the oldest task of
+    // another worker. The deques are guarded by spinlocks, since the owner
+    // and thieves each hold the lock for only a few instructions.
+    //
+    // A worker that finds no work parks on a futex. Queuing a task wakes one
+    // parked worker, and only touches the futex word when some worker is
+    // parked.
+    class scheduler {
+            using promise_base = detail::promise_base;
+
+            class schedule_awaiter;
+
+            template <std::size_t N>
+            class when_all_awaiter;
+
+        public:
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Construct a scheduler.
+            //
+            // Starts workers worker threads (or one thread per hardware thread
+            // if workers is zero).
+            explicit scheduler(size_type workers = 0)
+                : size_(workers ? workers : std::max(1u, std::thread::hardware_concurrency())),
+                  workers_(std::make_unique<worker[]>(size_)),
+                  stopping_(false),
+                  sleepers_(0),
+                  wake_seq_(0),
+                  pending_(0),
+                  next_(0) {
+                for (size_type i = 0; i < size_; ++i) {
+                    workers_[i].seed_ = static_cast<std::uint32_t>(i * 2654435761u + 1);
+                }
+                for (size_type i = 0; i < size_; ++i) {
+                    workers_[i].thread_ = std::thread([this, i] { run(workers_[i]); });
+                }
+            }
+
+            // Destroy a scheduler.
+            //
+            // Waits for all of the tasks started by spawn to finish, and then
+            // stops the worker threads.
+            ~scheduler() {
+                stopping_.store(true, std::memory_order_seq_cst);
+                wake_all();
+                for (size_type i = 0; i < size_; ++i) {
+                    workers_[i].thread_.join();
+                }
+            }
+
+            // Do not allow the copying of schedulers.
+            scheduler(const scheduler&) = delete;
+            scheduler& operator=(const scheduler&) = delete;
+
+            // Returns the number of worker threads.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the calling thread is a worker of the scheduler.
+            bool on_worker() const {
+                return current_ && current_->scheduler_ == this;
+            }
+
+            // Returns an awaitable that suspends the awaiting task and queues it
+            // on the scheduler, so that it resumes on a worker thread.
+            schedule_awaiter schedule() {
+                return schedule_awaiter{this};
+            }
+
+            // Starts the task t on the scheduler, detached: its coroutine frame
+            // is destroyed when it finishes. An exception that escapes the task
+            // terminates the program.
+            //
+            // Precondition:
+            // The task has a coroutine, which has not been started.
+            void spawn(task<void> t) {
+                assert(t && !t.done());
+                promise_base& p = std::exchange(t.handle_, nullptr).promise();
+                pending_.fetch_add(1, std::memory_order_relaxed);
+                p.pending_ = &pending_;
+                enqueue(p);
+            }
+
+            // Starts the task t on the scheduler and blocks the calling thread
+            // until it finishes. The result of the task is returned (or the
+            // exception that ended it is rethrown).
+            //
+            // Precondition:
+            // The calling thread is not a worker of the scheduler, and the task
+            // has a coroutine, which has not been started.
+            template <class T>
+            T sync_wait(task<T> t) {
+                assert(!on_worker());
+                assert(t && !t.done());
+                detail::join_state join(1);
+                t.handle_.promise().join_ = &join;
+                enqueue(t.handle_.promise());
+                join.wait();
+                return t.handle_.promise().take();
+            }
+
+            // Returns an awaitable that starts the tasks ts concurrently and
+            // resumes the awaiting task once all of them have finished. The
+            // first task runs immediately on the current thread, and the others
+            // are queued on the current worker, from which idle workers steal
+            // them. Each task may then be awaited to obtain its result (or the
+            // exception that ended it) without suspending.
+            //
+            // Precondition:
+            // The tasks have coroutines, which have not been started, and the
+            // awaiting task runs on a worker of the scheduler.
+            template <class... Ts>
+            when_all_awaiter<sizeof...(Ts)> when_all(task<Ts>&... ts) {
+                assert(on_worker());
+                assert(((ts && !ts.done()) && ...));
+                return when_all_awaiter<sizeof...(Ts)>(*this, {static_cast<promise_base*>(&ts.handle_.promise())...});
+            }
+
+        private:
+            // The awaitable returned by schedule.
+            class schedule_awaiter {
+                public:
+                    bool await_ready() {
+                        return false;
+                    }
+
+                    template <class Promise>
+                    void await_suspend(std::coroutine_handle<Promise> h) {
+                        static_assert(std::is_base_of_v<promise_base, Promise>, "Only a task can be scheduled");
+                        scheduler_->enqueue(h.promise());
+                    }
+
+                    void await_resume() {}
+
+                    scheduler* scheduler_;
+            };
+
+            // The awaitable returned by when_all for N tasks.
+            template <std::size_t N>
+            class when_all_awaiter {
+                public:
+                    when_all_awaiter(scheduler& s, const std::array<promise_base*, N>& promises)
+                        : scheduler_(&s), promises_(promises), join_(N) {}
+
+                    bool await_ready() {
+                        return N == 0;
+                    }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) {
+                        join_.parent = parent;
+                        for (promise_base* p : promises_) {
+                            p->join_ = &join_;
+                        }
+                        // Queue the others in reverse, so that the owner runs
+                        // them in order and thieves take the last ones.
+                        for (std::size_t i = N; i > 1; --i) {
+                            scheduler_->enqueue(*promises_[i - 1]);
+                        }
+                        return promises_[0]->self_;
+                    }
+
+                    void await_resume() {}
+
+                private:
+                    scheduler* scheduler_;
+                    std::array<promise_base*, N> promises_;
+                    detail::join_state join_;
+            };
+
+            // The state of a worker thread.
+            struct alignas(64) worker {
+                worker() : scheduler_(nullptr), seed_(1) {}
+
+                // The scheduler of the worker.
+                scheduler* scheduler_;
+                // Guards the deque.
+                ra::sync::spinlock lock_;
+                // The ready tasks, from the oldest to the most recent.
+                ra::intrusive::list<promise_base, &promise_base::hook_> deque_;
+                // The state of the random choice of victims.
+                std::uint32_t seed_;
+                std::thread thread_;
+            };
+
+            // Queues the ready task p on the current worker (or, from another
+            // thread, on the workers in turn), and wakes a parked worker.
+            void enqueue(promise_base& p) {
+                worker& w = on_worker() ? *current_ : workers_[next_.fetch_add(1, std::memory_order_relaxed) % size_];
+                {
+                    std::lock_guard<ra::sync::spinlock> lock(w.lock_);
+                    w.deque_.push_back(p);
+                }
+
+                // This pairs with the fence in park, so that either the worker
+                // going to sleep sees the task or it is seen to be parked here.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (sleepers_.load(std::memory_order_relaxed) != 0) {
+                    wake_seq_.fetch_add(1, std::memory_order_release);
+                    ra::sync::futex_wake(wake_seq_, 1);
+                }
+            }
+
+            // Wakes every parked worker.
+            void wake_all() {
+                wake_seq_.fetch_add(1, std::memory_order_release);
+                ra::sync::futex_wake_all(wake_seq_);
+            }
+
+            // Takes the most recent task of the deque of w.
+            static promise_base* pop(worker& w) {
+                std::lock_guard<ra::sync::spinlock> lock(w.lock_);
+                if (w.deque_.empty()) {
+                    return nullptr;
+                }
+                promise_base* p = &w.deque_.back();
+                w.deque_.pop_back();
+                return p;
+            }
+
+            // Takes the oldest task of the deque of a worker other than w,
+            // starting from a random victim.
+            promise_base* steal(worker& w) {
+                w.seed_ ^= w.seed_ << 13;
+                w.seed_ ^= w.seed_ >> 17;
+                w.seed_ ^= w.seed_ << 5;
+                size_type start = w.seed_ % size_;
+                for (size_type i = 0; i < size_; ++i) {
+                    worker& victim = workers_[(start + i) % size_];
+                    if (&victim == &w) {
+                        continue;
+                    }
+                    std::lock_guard<ra::sync::spinlock> lock(victim.lock_);
+                    if (!victim.deque_.empty()) {
+                        promise_base* p = &*victim.deque_.begin();
+                        victim.deque_.erase(victim.deque_.begin());
+                        return p;
+                    }
+                }
+                return nullptr;
+            }
+
+            // Returns true if any deque holds a task.
+            bool has_work() {
+                for (size_type i = 0; i < size_; ++i) {
+                    std::lock_guard<ra::sync::spinlock> lock(workers_[i].lock_);
+                    if (!workers_[i].deque_.empty()) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Parks the calling worker until a task is queued. Returns false
+            // if the worker should stop instead.
+            bool park() {
+                std::uint32_t seq = wake_seq_.load(std::memory_order_acquire);
+                sleepers_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                bool stop = false;
+                if (!has_work()) {
+                    if (stopping_.load(std::memory_order_relaxed) && pending_.load(std::memory_order_acquire) == 0) {
+                        stop = true;
+                    } else {
+                        ra::sync::futex_wait(wake_seq_, seq);
+                    }
+                }
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                return !stop;
+            }
+
+            // The body of the worker thread of w.
+            void run(worker& w) {
+                w.scheduler_ = this;
+                current_ = &w;
+                for (;;) {
+                    promise_base* p = pop(w);
+                    if (!p) {
+                        p = steal(w);
+                    }
+                    if (p) {
+                        p->self_.resume();
+                    } else if (!park()) {
+                        break;
+                    }
+                }
+                current_ = nullptr;
+                // Let the other workers see that there is nothing left.
+                wake_all();
+            }
+
+            size_type size_;
+
+            std::unique_ptr<worker[]> workers_;
+
+            // Set when the scheduler is being destroyed.
+            std::atomic<bool> stopping_;
+
+            // The number of parked workers.
+            alignas(64) std::atomic<std::uint32_t> sleepers_;
+
+            // The futex word that parked workers wait on, which changes on each
+            // wake.
+            std::atomic<std::uint32_t> wake_seq_;
+
+            // The number of unfinished detached tasks.
+            alignas(64) std::atomic<size_type> pending_;
+
+            // The next worker to queue a task from another thread on.
+            std::atomic<size_type> next_;
+
+            // The worker run by the calling thread (if any).
+            static inline thread_local worker* current_ = nullptr;
+    };
+}  // namespace ra::exec
+
+#endif
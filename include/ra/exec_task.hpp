@@ -0,0 +1,287 @@
+#ifndef ra_exec_task_hpp
+#define ra_exec_task_hpp
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <ra/intrusive_list.hpp>
+#include <ra/sync_futex.hpp>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace ra::exec {
+    class scheduler;
+
+    template <class T>
+    class task;
+
+    namespace detail {
+        // The rendezvous of the tasks started together by a fork (or by
+        // sync_wait). The last task to finish resumes the parent coroutine
+        // if there is one, or otherwise sets done and wakes any thread
+        // blocked on it.
+        struct join_state {
+            explicit join_state(std::size_t count, std::coroutine_handle<> parent = nullptr)
+                : remaining(count), parent(parent), done(0) {}
+
+            // Records the end of one task, and returns the coroutine to
+            // resume next.
+            std::coroutine_handle<> arrive() {
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                    return std::noop_coroutine();
+                }
+                if (parent) {
+                    return parent;
+                }
+                done.store(1, std::memory_order_release);
+                ra::sync::futex_wake_all(done);
+                return std::noop_coroutine();
+            }
+
+            // Blocks the calling thread until the last task has finished.
+            void wait() {
+                while (done.load(std::memory_order_acquire) == 0) {
+                    ra::sync::futex_wait(done, 0);
+                }
+            }
+
+            std::atomic<std::size_t> remaining;
+            std::coroutine_handle<> parent;
+            std::atomic<std::uint32_t> done;
+        };
+
+        // The part of the promise of a task that is independent of its
+        // result type.
+        // This contains the intrusive hook that links a ready task into the
+        // run queue of a scheduler worker, so scheduling a task never
+        // allocates memory, and the record of what to do when the task
+        // finishes: resume the coroutine awaiting it, arrive at a join,
+        // or (for a detached task) destroy the frame.
+        class promise_base {
+            public:
+                promise_base() : continuation_(nullptr), join_(nullptr), pending_(nullptr) {}
+
+                // A task is started lazily, when it is awaited or scheduled.
+                std::suspend_always initial_suspend() noexcept {
+                    return {};
+                }
+
+                struct final_awaiter {
+                    bool await_ready() noexcept {
+                        return false;
+                    }
+
+                    template <class Promise>
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                        promise_base& p = h.promise();
+                        if (p.continuation_) {
+                            return p.continuation_;
+                        }
+                        if (p.join_) {
+                            // The frame may be destroyed as soon as the join is
+                            // reached, so it is not touched afterwards.
+                            return p.join_->arrive();
+                        }
+                        if (p.pending_) {
+                            std::atomic<std::size_t>* pending = p.pending_;
+                            h.destroy();
+                            pending->fetch_sub(1, std::memory_order_release);
+                        }
+                        return std::noop_coroutine();
+                    }
+
+                    void await_resume() noexcept {}
+                };
+
+                final_awaiter final_suspend() noexcept {
+                    return {};
+                }
+
+            protected:
+                // Returns true if the task has been detached (see
+                // scheduler::spawn).
+                bool detached() const {
+                    return pending_ != nullptr;
+                }
+
+            private:
+                // Links the task into a run queue while it is ready.
+                ra::intrusive::list_hook hook_;
+                // The coroutine of the task.
+                std::coroutine_handle<> self_;
+                // The coroutine awaiting the task (if any).
+                std::coroutine_handle<> continuation_;
+                // The join the task arrives at when it finishes (if any).
+                join_state* join_;
+                // The count of unfinished detached tasks of the scheduler, if
+                // the task is detached.
+                std::atomic<std::size_t>* pending_;
+
+                template <class T>
+                friend class ra::exec::task;
+                friend class ra::exec::scheduler;
+        };
+
+        // The part of the promise of a task that stores its result.
+        template <class T>
+        class promise_result : public promise_base {
+            public:
+                template <class U>
+                    requires std::is_convertible_v<U&&, T>
+                void return_value(U&& value) {
+                    result_.template emplace<1>(std::forward<U>(value));
+                }
+
+                void unhandled_exception() {
+                    if (detached()) {
+                        std::terminate();
+                    }
+                    result_.template emplace<2>(std::current_exception());
+                }
+
+                // Returns the result of the finished task, or rethrows the
+                // exception that ended it.
+                T take() {
+                    if (result_.index() == 2) {
+                        std::rethrow_exception(std::get<2>(result_));
+                    }
+                    return std::move(std::get<1>(result_));
+                }
+
+            private:
+                std::variant<std::monostate, T, std::exception_ptr> result_;
+        };
+
+        template <>
+        class promise_result<void> : public promise_base {
+            public:
+                void return_void() {}
+
+                void unhandled_exception() {
+                    if (detached()) {
+                        std::terminate();
+                    }
+                    exception_ = std::current_exception();
+                }
+
+                void take() {
+                    if (exception_) {
+                        std::rethrow_exception(exception_);
+                    }
+                }
+
+            private:
+                std::exception_ptr exception_;
+        };
+    }  // namespace detail
+
+    // Lazily started coroutine task.
+    //
+    // A task is a coroutine returning task<T>. It does not run until it is
+    // awaited (in which case it runs on the thread of the awaiting coroutine,
+    // which resumes when the task finishes) or handed to a scheduler (see
+    // scheduler::spawn, sync_wait and when_all). The task object owns the
+    // coroutine frame, which embeds the intrusive hook through which a
+    // scheduler queues the task, so the frame is the only allocation made
+    // for a task.
+    //
+    // Awaiting a task yields its result (by moving it out of the frame), or
+    // rethrows the exception that ended it. A task that has already
+    // finished (e.g., after a when_all) may be awaited to obtain its result
+    // without suspending.
+    template <class T = void>
+    class [[nodiscard]] task {
+        public:
+            // The type of the result of the task.
+            using value_type = T;
+
+            class promise_type : public detail::promise_result<T> {
+                public:
+                    task get_return_object() {
+                        auto h = std::coroutine_handle<promise_type>::from_promise(*this);
+                        this->self_ = h;
+                        return task(h);
+                    }
+            };
+
+            // Default construct a task.
+            // This constructor creates a task without a coroutine.
+            task() : handle_(nullptr) {}
+
+            // Move construct a task.
+            // After the move, other has no coroutine.
+            task(task&& other) : handle_(std::exchange(other.handle_, nullptr)) {}
+
+            // Move assign a task.
+            // The coroutine of *this (if any) is destroyed, and the coroutine of
+            // other is then moved to *this.
+            task& operator=(task&& other) {
+                if (this != &other) {
+                    if (handle_) {
+                        handle_.destroy();
+                    }
+                    handle_ = std::exchange(other.handle_, nullptr);
+                }
+                return *this;
+            }
+
+            // Destroy a task.
+            // The coroutine must not be running (i.e., it must either not have
+            // been started or have finished).
+            ~task() {
+                if (handle_) {
+                    handle_.destroy();
+                }
+            }
+
+            // Do not allow the copying of tasks.
+            task(const task&) = delete;
+            task& operator=(const task&) = delete;
+
+            // Returns true if the task has a coroutine.
+            explicit operator bool() const {
+                return handle_ != nullptr;
+            }
+
+            // Returns true if the task has finished.
+            bool done() const {
+                return handle_ && handle_.done();
+            }
+
+            // Awaits the task, starting it if it has not been started.
+            auto operator co_await() {
+                struct awaiter {
+                    bool await_ready() {
+                        return handle_.done();
+                    }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+                        handle_.promise().continuation_ = awaiting;
+                        return handle_;
+                    }
+
+                    T await_resume() {
+                        return handle_.promise().take();
+                    }
+
+                    std::coroutine_handle<promise_type> handle_;
+                };
+
+                assert(handle_);
+                return awaiter{handle_};
+            }
+
+        private:
+            explicit task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+            std::coroutine_handle<promise_type> handle_;
+
+            friend class scheduler;
+    };
+}  // namespace ra::exec
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef ra_intrusive_atomic_stack_hpp
+#define ra_intrusive_atomic_stack_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+
+namespace ra::intrusive {
+    template <class T, auto Hook>
+    class atomic_stack;
+
+    // Per-node stack management information class.
+    // This type contains the pointer to the node below a node in an
+    // atomic_stack. The pointer is atomic since a thread popping a node may
+    // read it while another thread pops and pushes the same node. This class
+    // has the atomic_stack class template as a friend.
+    class atomic_stack_hook {
+        public:
+            // Default construct a stack hook.
+            // This constructor creates a stack hook that does not belong to any
+            // stack.
+            atomic_stack_hook() : next_(nullptr) {}
+
+            // Copy construct a stack hook.
+            // This constructor creates a stack hook that does not belong to any
+            // stack. The argument to the constructor is ignored.
+            atomic_stack_hook(const atomic_stack_hook&) : next_(nullptr) {}
+
+            // Copy assign a stack hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            atomic_stack_hook& operator=(const atomic_stack_hook&) { return *this; }
+
+            // Destroy a stack hook.
+            // The stack hook being destroyed must not belong to a stack. If the
+            // stack hook belongs to a stack, the resulting behavior is undefined.
+            ~atomic_stack_hook() = default;
+
+        private:
+            // The next node in the stack (i.e., the node below this one).
+            std::atomic<atomic_stack_hook*> next_;
+
+            // Friend the atomic_stack class template.
+            template <class T, auto H>
+            friend class atomic_stack;
+    };
+
+    // Intrusive lock-free stack (Treiber stack).
+    //
+    // The elements are linked through the atomic_stack_hook selected by Hook
+    // (see hook_traits), and no memory is ever allocated by the stack. All
+    // member functions may be called concurrently by any number of threads.
+    //
+    // The top of the stack is a single 64-bit word holding the node pointer
+    // in its low 48 bits and a modification tag in its high 16 bits. Every
+    // successful update increments the tag, so a pop cannot succeed with a
+    // stale view of the top after the same node has been popped and pushed
+    // again in the meantime (the ABA problem). This requires that user-space
+    // addresses fit in 48 bits (as on x86-64 and AArch64 with 4-level page
+    // tables).
+    //
+    // As with any Treiber stack, a pop may read the hook of a node that has
+    // concurrently been popped by another thread. The memory of a popped
+    // element must therefore remain readable (e.g., by recycling elements
+    // through the stack as a free list, or by deferring reclamation).
+    template <class T, auto Hook>
+    class atomic_stack {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using node = atomic_stack_hook;
+
+            static_assert(std::is_same_v<typename traits::hook_type, node>, "Hook must select an atomic_stack_hook");
+            static_assert(sizeof(void*) == sizeof(std::uint64_t), "atomic_stack requires 64-bit pointers");
+
+        public:
+            // The type of the elements in the stack.
+            using value_type = T;
+
+            // The type of a mutating reference to an element in the stack.
+            using reference = T&;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a stack.
+            //
+            // Creates an empty stack.
+            //
+            // Time complexity:
+            // Constant.
+            atomic_stack() : top_(0) {}
+
+            // Destroy a stack.
+            //
+            // The elements still in the stack are simply abandoned (i.e., their
+            // hooks are left linked).
+            //
+            // Time complexity:
+            // Constant.
+            ~atomic_stack() = default;
+
+            // Do not allow the copying or moving of stacks.
+            atomic_stack(const atomic_stack&) = delete;
+            atomic_stack& operator=(const atomic_stack&) = delete;
+
+            // Pushes the element x onto the stack.
+            //
+            // Time complexity:
+            // Constant (lock-free).
+            void push(reference x) {
+                node* n = traits::to_hook(&x);
+                link(n, n);
+            }
+
+            // Pushes the elements in the range [first, last) onto the stack
+            // with a single atomic update. The elements are linked together
+            // before they are published, and the last element of the range
+            // ends up on top of the stack (as if each element had been pushed
+            // in turn).
+            //
+            // Template constraints:
+            // The type InputIterator must meet the requirements of an input
+            // iterator whose reference type is T&.
+            //
+            // Time complexity:
+            // Linear in the number of elements pushed.
+            template <class InputIterator>
+            void push_list(InputIterator first, InputIterator last) {
+                if (first == last) {
+                    return;
+                }
+
+                node* bottom = traits::to_hook(&*first);
+                node* top = bottom;
+                for (++first; first != last; ++first) {
+                    node* n = traits::to_hook(&*first);
+                    n->next_.store(top, std::memory_order_relaxed);
+                    top = n;
+                }
+
+                link(top, bottom);
+            }
+
+            // Pops the element on top of the stack.
+            // A pointer to the popped element is returned, or null if the stack
+            // is empty.
+            //
+            // Time complexity:
+            // Constant (lock-free).
+            T* pop() {
+                std::uint64_t top = top_.load(std::memory_order_acquire);
+
+                for (;;) {
+                    node* n = to_node(top);
+                    if (!n) {
+                        return nullptr;
+                    }
+
+                    node* next = n->next_.load(std::memory_order_relaxed);
+                    if (top_.compare_exchange_weak(top, make_top(next, top), std::memory_order_acquire,
+                                                   std::memory_order_acquire)) {
+                        return traits::to_value(n);
+                    }
+                }
+            }
+
+            // Pops all of the elements from the stack with a single atomic
+            // update, passing each to the function object f (from the top of the
+            // stack to the bottom). The element is no longer referenced by the
+            // stack when f is called, so f may dispose of it or push it again.
+            // The number of elements popped is returned.
+            //
+            // Time complexity:
+            // Linear in the number of elements popped.
+            template <class F>
+            size_type pop_all(F f) {
+                std::uint64_t top = top_.load(std::memory_order_relaxed);
+                while (to_node(top) &&
+                       !top_.compare_exchange_weak(top, make_top(nullptr, top), std::memory_order_acquire,
+                                                   std::memory_order_relaxed)) {
+                }
+
+                size_type count = 0;
+                for (node* n = to_node(top); n;) {
+                    node* next = n->next_.load(std::memory_order_relaxed);
+                    f(*traits::to_value(n));
+                    n = next;
+                    ++count;
+                }
+
+                return count;
+            }
+
+            // Returns true if the stack is empty (at the instant of the call).
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return to_node(top_.load(std::memory_order_acquire)) == nullptr;
+            }
+
+        private:
+            // The number of low bits of the top word holding the node pointer.
+            static constexpr int pointer_bits = 48;
+
+            // The mask selecting the node pointer in the top word.
+            static constexpr std::uint64_t pointer_mask = (std::uint64_t(1) << pointer_bits) - 1;
+
+            // Returns the node pointer held in a top word.
+            static node* to_node(std::uint64_t top) {
+                return reinterpret_cast<node*>(static_cast<std::uintptr_t>(top & pointer_mask));
+            }
+
+            // Returns the top word that replaces old_top with the node n (which
+            // carries the incremented tag).
+            static std::uint64_t make_top(node* n, std::uint64_t old_top) {
+                std::uint64_t tag = (old_top >> pointer_bits) + 1;
+                return (tag << pointer_bits) | static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(n));
+            }
+
+            // Publishes the chain of nodes from top down to bottom (which are
+            // already linked to each other) on top of the stack.
+            void link(node* top, node* bottom) {
+                std::uint64_t old_top = top_.load(std::memory_order_relaxed);
+                do {
+                    bottom->next_.store(to_node(old_top), std::memory_order_relaxed);
+                } while (!top_.compare_exchange_weak(old_top, make_top(top, old_top), std::memory_order_release,
+                                                     std::memory_order_relaxed));
+            }
+
+            // The top of the stack (node pointer and modification tag).
+            std::atomic<std::uint64_t> top_;
+    };
+}  // namespace ra::intrusive
+
+#endif
@@ -0,0 +1,449 @@
+#ifndef ra_intrusive_concurrent_list_hpp
+#define ra_intrusive_concurrent_list_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ra/intrusive_hook_traits.hpp>
+#include <thread>
+#include <type_traits>
+
+namespace ra::intrusive {
+    template <class T, auto Hook>
+    class concurrent_list;
+
+    // Per-node concurrent list management information class.
+    // This type contains the successor and predecessor of a node in a
+    // concurrent_list, and a version word whose low bit is the lock of the
+    // node. Locking and unlocking a node each increment the version, so the
+    // version is odd exactly while the node is locked, and a reader that
+    // sees the same even version before and after reading the links of a
+    // node knows that the links did not change in between. This class has
+    // the concurrent_list class template as a friend.
+    class concurrent_list_hook {
+        public:
+            // Default construct a concurrent list hook.
+            // This constructor creates a hook that does not belong to any list.
+            concurrent_list_hook() : next_(nullptr), prev_(nullptr), version_(0) {}
+
+            // Copy construct a concurrent list hook.
+            // This constructor creates a hook that does not belong to any list.
+            // The argument to the constructor is ignored.
+            concurrent_list_hook(const concurrent_list_hook&) : concurrent_list_hook() {}
+
+            // Copy assign a concurrent list hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            concurrent_list_hook& operator=(const concurrent_list_hook&) { return *this; }
+
+            // Destroy a concurrent list hook.
+            // The hook being destroyed must not belong to a list, and no reader
+            // may still be traversing it (see concurrent_list).
+            ~concurrent_list_hook() = default;
+
+        private:
+            // The next node in the list.
+            std::atomic<concurrent_list_hook*> next_;
+            // The previous node in the list.
+            std::atomic<concurrent_list_hook*> prev_;
+            // The version of the links of the node (odd while locked).
+            std::atomic<std::uint32_t> version_;
+
+            // Friend the concurrent_list class template.
+            template <class T, auto H>
+            friend class concurrent_list;
+    };
+
+    // Intrusive doubly-linked list with fine-grained locking.
+    //
+    // The elements are linked through the concurrent_list_hook selected by
+    // Hook (see hook_traits). Instead of one lock for the whole list, each
+    // node has a lock bit in its hook, and an operation locks only the nodes
+    // whose links it changes: inserting locks the two neighbours of the new
+    // element, and erasing locks the element and its two neighbours. Nodes
+    // are always locked in list order (from the head sentinel towards the
+    // tail sentinel), so operations cannot deadlock, and operations on
+    // disjoint regions of the list proceed in parallel.
+    //
+    // Traversals come in two flavours. Hand-over-hand traversals
+    // (insert_sorted, erase_if, for_each_locked) lock the next node before
+    // unlocking the current one, so they see a consistent list and may
+    // modify it as they go. Optimistic traversals (find_if, count_if) take no
+    // locks at all: they validate each step against the version of the node
+    // they stepped from, and restart from the head when a node they depend
+    // on has changed.
+    //
+    // Precondition:
+    // An element is inserted or erased by one thread at a time, and an
+    // element passed as a position is not erased concurrently. Since
+    // optimistic traversals may still be reading an erased element, its
+    // memory must remain valid until they have finished (e.g., by retiring
+    // erased elements through ra::reclaim::epoch_domain, or by never
+    // freeing elements while the list is in use).
+    template <class T, auto Hook>
+    class concurrent_list {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using node = concurrent_list_hook;
+
+            static_assert(std::is_same_v<typename traits::hook_type, node>, "Hook must select a concurrent_list_hook");
+
+        public:
+            // The type of the elements in the list.
+            using value_type = T;
+
+            // The type of a mutating reference to an element in the list.
+            using reference = T&;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a list.
+            //
+            // Creates an empty list.
+            //
+            // Time complexity:
+            // Constant.
+            concurrent_list() : size_(0) {
+                head_.next_.store(&tail_, std::memory_order_relaxed);
+                tail_.prev_.store(&head_, std::memory_order_relaxed);
+            }
+
+            // Destroy a list.
+            //
+            // The elements still in the list are simply abandoned (i.e., their
+            // hooks are left linked). No other thread may be using the list.
+            //
+            // Time complexity:
+            // Constant.
+            ~concurrent_list() = default;
+
+            // Do not allow the copying or moving of lists.
+            concurrent_list(const concurrent_list&) = delete;
+            concurrent_list& operator=(const concurrent_list&) = delete;
+
+            // Returns the number of elements in the list. While other threads
+            // modify the list, the result is only a snapshot.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_.load(std::memory_order_relaxed);
+            }
+
+            // Returns true if the list contains no elements (see size).
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return size() == 0;
+            }
+
+            // Inserts the element x at the front of the list.
+            //
+            // Time complexity:
+            // Constant (plus waiting for the locks of the neighbours).
+            void push_front(reference x) {
+                lock(&head_);
+                link_after(&head_, traits::to_hook(&x));
+            }
+
+            // Inserts the element x at the back of the list.
+            //
+            // Time complexity:
+            // Constant (plus waiting for the locks of the neighbours).
+            void push_back(reference x) {
+                link_after(lock_prev(&tail_), traits::to_hook(&x));
+            }
+
+            // Inserts the element x before the element pos, which must belong
+            // to the list.
+            //
+            // Time complexity:
+            // Constant (plus waiting for the locks of the neighbours).
+            void insert(reference pos, reference x) {
+                link_after(lock_prev(traits::to_hook(&pos)), traits::to_hook(&x));
+            }
+
+            // Erases the element x, which must belong to the list.
+            //
+            // Time complexity:
+            // Constant (plus waiting for the locks of the neighbours).
+            void erase(reference x) {
+                node* n = traits::to_hook(&x);
+                node* prev = lock_prev(n);
+                lock(n);
+                unlink_locked(prev, n);
+                unlock(n);
+                unlock(prev);
+            }
+
+            // Inserts the element x before the first element y for which
+            // comp(y, x) is false, walking the list hand over hand. If the list
+            // is kept sorted by comp this way, it remains sorted.
+            //
+            // Time complexity:
+            // Linear in the number of elements before the insertion point.
+            template <class Compare>
+            void insert_sorted(reference x, Compare comp) {
+                node* prev = &head_;
+                lock(prev);
+                for (;;) {
+                    node* cur = prev->next_.load(std::memory_order_relaxed);
+                    if (cur == &tail_ || !comp(*traits::to_value(cur), x)) {
+                        link_after(prev, traits::to_hook(&x));
+                        return;
+                    }
+                    lock(cur);
+                    unlock(prev);
+                    prev = cur;
+                }
+            }
+
+            // Erases every element x for which pred(x) is true, walking the
+            // list hand over hand, and then calls disposer(x) for each of them
+            // (after x is unlinked and unlocked). The number of erased elements
+            // is returned.
+            //
+            // Time complexity:
+            // Linear in size().
+            template <class Predicate, class Disposer>
+            size_type erase_if(Predicate pred, Disposer disposer) {
+                size_type count = 0;
+                node* prev = &head_;
+                lock(prev);
+                for (;;) {
+                    node* cur = prev->next_.load(std::memory_order_relaxed);
+                    if (cur == &tail_) {
+                        break;
+                    }
+                    lock(cur);
+                    if (pred(*traits::to_value(cur))) {
+                        unlink_locked(prev, cur);
+                        unlock(cur);
+                        ++count;
+                        disposer(*traits::to_value(cur));
+                    } else {
+                        unlock(prev);
+                        prev = cur;
+                    }
+                }
+                unlock(prev);
+                return count;
+            }
+            template <class Predicate>
+            size_type erase_if(Predicate pred) {
+                return erase_if(pred, [](reference) {});
+            }
+
+            // Calls f(x) for each element x in list order, walking the list hand
+            // over hand, so that no element is inserted or erased next to x
+            // while f runs.
+            //
+            // Time complexity:
+            // Linear in size().
+            template <class F>
+            void for_each_locked(F f) {
+                node* prev = &head_;
+                lock(prev);
+                for (;;) {
+                    node* cur = prev->next_.load(std::memory_order_relaxed);
+                    if (cur == &tail_) {
+                        break;
+                    }
+                    lock(cur);
+                    unlock(prev);
+                    f(*traits::to_value(cur));
+                    prev = cur;
+                }
+                unlock(prev);
+            }
+
+            // Returns the first element x for which pred(x) is true, or null if
+            // there is none, without taking any locks. The returned element was
+            // in the list when pred accepted it. Since pred may be called with
+            // an element that is being erased concurrently (and again after a
+            // restart), it must only read the element.
+            //
+            // Time complexity:
+            // Linear in size() (plus restarts caused by concurrent changes).
+            template <class Predicate>
+            T* find_if(Predicate pred) const {
+                T* found = nullptr;
+                traverse([&](const node* n) {
+                    if (pred(*traits::to_value(n))) {
+                        found = traits::to_value(const_cast<node*>(n));
+                        return false;
+                    }
+                    return true;
+                });
+                return found;
+            }
+
+            // Returns the number of elements x for which pred(x) is true,
+            // without taking any locks (see find_if). Each element counted was
+            // in the list when the traversal reached it.
+            //
+            // Time complexity:
+            // Linear in size() (plus restarts caused by concurrent changes).
+            template <class Predicate>
+            size_type count_if(Predicate pred) const {
+                size_type count = 0;
+                traverse(
+                    [&](const node* n) {
+                        if (pred(*traits::to_value(n))) {
+                            ++count;
+                        }
+                        return true;
+                    },
+                    [&] { count = 0; });
+                return count;
+            }
+
+        private:
+            // Spins once, giving way to other threads now and then.
+            static void relax(int& spins) {
+                if (++spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+                    __builtin_ia32_pause();
+#endif
+                } else {
+                    spins = 0;
+                    std::this_thread::yield();
+                }
+            }
+
+            // Locks the node n.
+            static void lock(node* n) {
+                int spins = 0;
+                for (;;) {
+                    std::uint32_t v = n->version_.load(std::memory_order_relaxed);
+                    if ((v & 1) == 0 &&
+                        n->version_.compare_exchange_weak(v, v + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        // Order the odd version before the changes to the
+                        // links, so that a reader that sees a change also sees
+                        // the version change when it validates.
+                        std::atomic_thread_fence(std::memory_order_release);
+                        return;
+                    }
+                    relax(spins);
+                }
+            }
+
+            // Unlocks the node n.
+            static void unlock(node* n) {
+                n->version_.fetch_add(1, std::memory_order_release);
+            }
+
+            // Returns the version of the node n once it is unlocked.
+            static std::uint32_t stable_version(const node* n) {
+                int spins = 0;
+                for (;;) {
+                    std::uint32_t v = n->version_.load(std::memory_order_acquire);
+                    if ((v & 1) == 0) {
+                        return v;
+                    }
+                    relax(spins);
+                }
+            }
+
+            // Locks the predecessor of the node n (which must not be erased
+            // concurrently), and returns it.
+            node* lock_prev(node* n) {
+                for (;;) {
+                    node* prev = n->prev_.load(std::memory_order_acquire);
+                    lock(prev);
+                    // The links of prev only change while it is locked, so n is
+                    // still its successor if it is now. An erased node keeps its
+                    // successor for the sake of readers, but loses its
+                    // predecessor.
+                    if (prev->next_.load(std::memory_order_relaxed) == n &&
+                        (prev == &head_ || prev->prev_.load(std::memory_order_relaxed) != nullptr)) {
+                        return prev;
+                    }
+                    unlock(prev);
+                }
+            }
+
+            // Links the node x after the locked node prev, and unlocks prev.
+            void link_after(node* prev, node* x) {
+                node* next = prev->next_.load(std::memory_order_relaxed);
+                lock(next);
+                x->next_.store(next, std::memory_order_relaxed);
+                x->prev_.store(prev, std::memory_order_relaxed);
+                // Publish x fully linked before readers can reach it.
+                prev->next_.store(x, std::memory_order_release);
+                next->prev_.store(x, std::memory_order_release);
+                size_.fetch_add(1, std::memory_order_relaxed);
+                unlock(next);
+                unlock(prev);
+            }
+
+            // Unlinks the locked node n from its locked predecessor prev. The
+            // successor of n is left intact, so that a concurrent reader
+            // standing on n can still move on (and then notice the change of
+            // version).
+            void unlink_locked(node* prev, node* n) {
+                node* next = n->next_.load(std::memory_order_relaxed);
+                lock(next);
+                prev->next_.store(next, std::memory_order_release);
+                next->prev_.store(prev, std::memory_order_release);
+                n->prev_.store(nullptr, std::memory_order_relaxed);
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                unlock(next);
+            }
+
+            // Visits the elements in list order with visit(n) (which returns
+            // false to stop) without locking, restarting from the head (after
+            // calling on_restart) whenever a node stepped from has changed.
+            template <class Visit, class OnRestart>
+            void traverse(Visit visit, OnRestart on_restart) const {
+            restart:
+                on_restart();
+                const node* cur = &head_;
+                std::uint32_t v = stable_version(cur);
+                for (;;) {
+                    const node* next = cur->next_.load(std::memory_order_acquire);
+                    if (next == &tail_) {
+                        // The traversal ends only if cur still led to the tail.
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (cur->version_.load(std::memory_order_relaxed) != v) {
+                            goto restart;
+                        }
+                        return;
+                    }
+                    std::uint32_t nv = stable_version(next);
+                    // Validate that cur still led to next after its version was
+                    // read (i.e., that next had not been erased).
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (cur->version_.load(std::memory_order_relaxed) != v) {
+                        goto restart;
+                    }
+                    if (!visit(next)) {
+                        // The element was accepted while it was linked, if its
+                        // version has not changed since.
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (next->version_.load(std::memory_order_relaxed) != nv) {
+                            goto restart;
+                        }
+                        return;
+                    }
+                    cur = next;
+                    v = nv;
+                }
+            }
+            template <class Visit>
+            void traverse(Visit visit) const {
+                traverse(visit, [] {});
+            }
+
+            // The sentinels before the first element and after the last one.
+            node head_;
+            node tail_;
+
+            std::atomic<size_type> size_;
+    };
+}  // namespace ra::intrusive
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef ra_intrusive_hook_traits_hpp
+#define ra_intrusive_hook_traits_hpp
+
+#include <ra/parent_from_member.hpp>
+#include <type_traits>
+
+namespace ra::intrusive {
+    // Base hook selector.
+    // A container is told where the hook of an element is located by a hook
+    // selector. The selector is either a pointer-to-member of the element type
+    // (for a member hook) or base_hook<Hook> (for an element type that derives
+    // from Hook).
+    template <class Hook>
+    struct base_hook_t {};
+
+    template <class Hook>
+    inline constexpr base_hook_t<Hook> base_hook{};
+
+    namespace detail {
+        // The hook type named by a hook selector type.
+        template <class Selector>
+        struct hook_selector_traits {
+            using hook_type = typename ra::util::member_pointer_traits<Selector>::member_type;
+            static constexpr bool is_base_hook = false;
+
+            // Whether the selector names a hook of the type T.
+            template <class T>
+            static constexpr bool selects_from =
+                std::is_same_v<typename ra::util::member_pointer_traits<Selector>::parent_type, T>;
+        };
+
+        template <class Hook>
+        struct hook_selector_traits<base_hook_t<Hook>> {
+            using hook_type = Hook;
+            static constexpr bool is_base_hook = true;
+
+            template <class T>
+            static constexpr bool selects_from = std::is_base_of_v<Hook, T>;
+        };
+    }  // namespace detail
+
+    // Hook traits class.
+    // This class converts between an element of type T and its hook, as
+    // selected by the hook selector Hook. Both conversions are resolved at
+    // compile time: a base hook is a static_cast, and a member hook is a
+    // constant adjustment by the offset of the member.
+    template <class T, auto Hook>
+    struct hook_traits {
+        private:
+            using selector_traits = detail::hook_selector_traits<std::remove_cvref_t<decltype(Hook)>>;
+
+        public:
+            // The type of the elements.
+            using value_type = T;
+
+            // The type of the hook.
+            using hook_type = typename selector_traits::hook_type;
+
+            // Whether the hook is a base class of the element type.
+            static constexpr bool is_base_hook = selector_traits::is_base_hook;
+
+            static_assert(selector_traits::template selects_from<T>, "Hook must select a base class or member of T");
+
+            // Returns the hook of an element.
+            static hook_type* to_hook(T* value) {
+                if constexpr (is_base_hook) {
+                    return static_cast<hook_type*>(value);
+                } else {
+                    return &(value->*Hook);
+                }
+            }
+            static const hook_type* to_hook(const T* value) {
+                if constexpr (is_base_hook) {
+                    return static_cast<const hook_type*>(value);
+                } else {
+                    return &(value->*Hook);
+                }
+            }
+
+            // Returns the element containing a hook.
+            static T* to_value(hook_type* hook) {
+                if constexpr (is_base_hook) {
+                    return static_cast<T*>(hook);
+                } else {
+                    return ra::util::parent_from_member<Hook>(hook);
+                }
+            }
+            static const T* to_value(const hook_type* hook) {
+                if constexpr (is_base_hook) {
+                    return static_cast<const T*>(hook);
+                } else {
+                    return ra::util::parent_from_member<Hook>(hook);
+                }
+            }
+    };
+}  // namespace ra::intrusive
+
+#endif
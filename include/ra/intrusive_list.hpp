@@ -1,23 +1,110 @@
+#ifndef ra_intrusive_list_hpp
+#define ra_intrusive_list_hpp
+
 #include <boost/iterator/iterator_facade.hpp>
-#include <ra/parent_from_member.hpp>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ra/intrusive_hook_traits.hpp>
 #include <type_traits>
+#include <utility>
 
 namespace ra::intrusive {
-    class list_hook;
-    template <class T, list_hook T::*Hook>
+    // The link modes of a list hook.
+    //
+    // normal: The hook is not reset when it is erased from a list, so
+    //     erasure writes only to the neighbouring nodes.
+    // safe: The hook is reset to the unlinked state when it is erased
+    //     from a list, so is_linked() may be queried, and inserting a linked
+    //     hook or destroying a linked hook is diagnosed (in debug builds).
+    // auto_unlink: As for safe, but destroying a linked hook unlinks it from
+    //     its list in constant time. A list of auto-unlink hooks does not
+    //     track its size (since elements may leave the list without the
+    //     list being involved), so its size() is linear time.
+    enum class link_mode { normal, safe, auto_unlink };
+
+    class list_node;
+    template <link_mode Mode>
+    class basic_list_hook;
+
+    namespace detail {
+        // Whether the type is an instance of basic_list_hook.
+        template <class>
+        inline constexpr bool is_list_hook = false;
+
+        template <link_mode Mode>
+        inline constexpr bool is_list_hook<basic_list_hook<Mode>> = true;
+
+        // Whether a list of T linked through Hook tracks its size by default
+        // (which a list of auto-unlink hooks cannot).
+        template <class T, auto Hook>
+        inline constexpr bool default_constant_time_size =
+            hook_traits<T, Hook>::hook_type::mode != link_mode::auto_unlink;
+    }  // namespace detail
+
+    template <class T, auto Hook, bool ConstantTimeSize = detail::default_constant_time_size<T, Hook>>
     class list;
 
+    // Per-node list links.
+    // This type contains the pointers to the successor and predecessor of a
+    // node in a list. It is the common base of all list hooks, and is also
+    // used (by itself) for the sentinel node of a list. This class has the
+    // list class template as a friend.
+    class list_node {
+        public:
+            // Default construct a list node.
+            // This constructor creates a node that does not belong to any list.
+            list_node() : next_(nullptr), prev_(nullptr) {}
+
+            // Copy construct a list node.
+            // This constructor creates a node that does not belong to any list.
+            // The argument to the constructor is ignored.
+            list_node(const list_node&) : next_(nullptr), prev_(nullptr) {}
+
+            // Copy assign a list node.
+            // The copy assignment operator is defined as a no-op.
+            list_node& operator=(const list_node&) { return *this; }
+
+        protected:
+            // Unlinks the node from the list containing it and resets the node
+            // to the unlinked state.
+            void unlink_node() {
+                prev_->next_ = next_;
+                next_->prev_ = prev_;
+                next_ = nullptr;
+                prev_ = nullptr;
+            }
+
+            // The next node in the list.
+            list_node* next_;
+            // The previous node in the list.
+            list_node* prev_;
+
+        private:
+            // Friend the list class template.
+            template <class T, auto H, bool C>
+            friend class list;
+
+            // Friend the list_iterator class template.
+            template <class P, auto H>
+            friend class list_iterator;
+    };
+
     // Per-node list management information class.
     // This type contains per-node list management information (i.e., the
-    // successor and predecessor in the list). This class has the list class
-    // template as a friend. This type must contain pointers (of type
-    // list_hook*) to the next and previous node in the list.
-    class list_hook {
+    // successor and predecessor in the list). The Mode parameter selects the
+    // link mode of the hook (see link_mode).
+    template <link_mode Mode>
+    class basic_list_hook : public list_node {
         public:
+            // The link mode of the hook.
+            static constexpr link_mode mode = Mode;
+
             // Default construct a list hook.
             // This constructor creates a list hook that does not belong to any
             // list.
-            list_hook() : next_(nullptr), prev_(nullptr) {}
+            basic_list_hook() = default;
 
             // Copy construct a list hook.
             // This constructor creates a list hook that does not belong to any
@@ -25,56 +112,73 @@ namespace ra::intrusive {
             // construction operation is defined only so that types with list hooks
             // are copy constructible. The list class itself never copies (or
             // moves) a list hook.
-            list_hook(const list_hook&) : next_(nullptr), prev_(nullptr) {}
+            basic_list_hook(const basic_list_hook&) : list_node() {}
 
             // Copy assign a list hook.
             // The copy assignment operator is defined as a no-op. The argument to
             // the operator is ignored. The copy assignment operation is defined
             // only so that types with list hooks are copy assignable. The list
             // class itself never copies (or moves) a list hook.
-            list_hook& operator=(const list_hook&) { return *this; }
+            basic_list_hook& operator=(const basic_list_hook&) { return *this; }
 
             // Destroy a list hook.
-            // The list hook being destroyed must not belong to a list. If the
-            // list hook belongs to a list, the resulting behavior is undefined.
-            ~list_hook() {
+            // In auto-unlink mode, a hook that belongs to a list is unlinked
+            // from the list. Otherwise, the list hook being destroyed must not
+            // belong to a list; if it does, the resulting behavior is undefined
+            // (and, in safe mode, an assertion fails in debug builds).
+            ~basic_list_hook() {
+                if constexpr (Mode == link_mode::auto_unlink) {
+                    if (is_linked()) {
+                        unlink_node();
+                    }
+                } else if constexpr (Mode == link_mode::safe) {
+                    assert(!is_linked());
+                }
                 next_ = nullptr;
                 prev_ = nullptr;
             }
 
-        private:
-            // The next node in the list.
-            list_hook* next_;
-            // The previous node in the list.
-            list_hook* prev_;
-
-            // Friend the list class template.
-            template <typename T, list_hook T::*H>
-            friend class list;
+            // Returns true if the hook belongs to a list.
+            //
+            // Time complexity:
+            // Constant.
+            bool is_linked() const
+            requires(Mode != link_mode::normal)
+            {
+                return next_ != nullptr;
+            }
 
-            // Friend the list_iterator class template.
-            template <class P>
-            friend class list_iterator;
+            // Unlinks the hook from the list containing it. This has no effect
+            // if the hook does not belong to a list.
+            //
+            // Time complexity:
+            // Constant.
+            void unlink()
+            requires(Mode == link_mode::auto_unlink)
+            {
+                if (is_linked()) {
+                    unlink_node();
+                }
+            }
     };
 
+    // The default list hook (which uses the normal link mode).
+    using list_hook = basic_list_hook<link_mode::normal>;
+
     // List iterator class.
-    // This class provides a forward iterator for lists. The iterator is
-    // bidirectional and can be used to traverse a list in either direction.
-    // The iterator is a random access iterator.
-    template <typename P>
-    class list_iterator : public boost::iterator_facade<list_iterator<P>, P, boost::bidirectional_traversal_tag> {
+    // This class provides a bidirectional iterator for lists. The iterator
+    // refers to a hook and uses the hook selector Hook to recover the element
+    // containing that hook (see hook_traits).
+    template <class P, auto Hook>
+    class list_iterator : public boost::iterator_facade<list_iterator<P, Hook>, P, boost::bidirectional_traversal_tag> {
         public:
+            // Construct a list iterator.
+            explicit list_iterator(list_node* node = nullptr) : node_(node) {}
+
+            // Convert a mutating iterator to a non-mutating one.
             template <class Other_ptr>
             requires std::is_convertible_v<Other_ptr*, P*>
-            list_iterator(const list_iterator<Other_ptr>& other) : node_(other.node_) {}
-
-            using typename boost::iterator_facade<list_iterator<P>, P,
-                                                  boost::bidirectional_traversal_tag>::reference;
-            using typename boost::iterator_facade<list_iterator<P>, P,
-                                                  boost::bidirectional_traversal_tag>::difference_type;
-
-            // Construct a list iterator.
-            explicit list_iterator(P* node = nullptr) : node_(node) {}
+            list_iterator(const list_iterator<Other_ptr, Hook>& other) : node_(other.node_) {}
 
             // Copy construct a list iterator.
             list_iterator(const list_iterator& other) = default;
@@ -82,79 +186,77 @@ namespace ra::intrusive {
             // Copy assign a list iterator.
             list_iterator& operator=(const list_iterator& other) = default;
 
-            // Dereference the list iterator.
-            // This operator returns a reference to the node pointed to by the
-            // list iterator.
-            P& operator*() const {
-                return *node_;
-            }
-
-            // Dereference the list iterator.
-            // This operator returns a pointer to the node pointed to by the
-            // list iterator.
-            P* operator->() const {
+            // Get the node referred to by the iterator.
+            list_node* get_node() const {
                 return node_;
             }
 
-            // Compare two list iterators.
-            bool operator==(const list_iterator& other) const {
-                return node_ == other.get_node();
-            }
+        private:
+            template <class Q, auto H>
+            friend class list_iterator;
 
-            // Compare two list iterators.
-            bool operator!=(const list_iterator& other) const {
-                return node_ != other.get_node();
-            }
+            // The conversions between hooks and elements.
+            using traits = hook_traits<std::remove_const_t<P>, Hook>;
 
-            // prefix increment.
-            list_iterator& operator++() {
-                node_ = node_->next_;
-                return *this;
-            }
+            friend class boost::iterator_core_access;
 
-            // postfix increment.
-            list_iterator operator++(int) {
-                list_iterator tmp(*this);
-                node_ = node_->next_;
-                return tmp;
+            P& dereference() const {
+                return *traits::to_value(static_cast<typename traits::hook_type*>(node_));
             }
 
-            // prefix decrement.
-            list_iterator& operator--() {
-                node_ = node_->prev_;
-                return *this;
+            bool equal(const list_iterator& other) const {
+                return node_ == other.node_;
             }
 
-            // postfix decrement.
-            list_iterator operator--(int) {
-                list_iterator tmp(*this);
-                node_ = node_->prev_;
-                return tmp;
+            void increment() {
+                node_ = node_->next_;
             }
 
-            P* get_node() const {
-                return node_;
+            void decrement() {
+                node_ = node_->prev_;
             }
 
-        private:
-            template <class>
-            friend class list_iterator;
-
-            friend class boost::iterator_core_access;
-
             // The node pointed to by the list iterator.
-            P* node_;
+            list_node* node_;
     };
 
     // Intrusive doubly-linked list (with sentinel node).
-    template <class T, list_hook T::*Hook>
+    // The Hook parameter selects the basic_list_hook object (of any link
+    // mode) that links the elements: either a pointer-to-member of T (e.g.,
+    // &T::hook), or base_hook<H> if T derives from the hook type H. An object
+    // with several hooks can belong to several lists at once.
+    //
+    // If ConstantTimeSize is true, the list tracks its size, so size() is
+    // constant time. If it is false, insertion and erasure do not write a
+    // counter, every form of splice is constant time, and size() is linear
+    // time. By default, the size is tracked unless the hook is auto-unlink
+    // (for which it cannot be).
+    template <class T, auto Hook, bool ConstantTimeSize>
     class list {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            static_assert(detail::is_list_hook<typename traits::hook_type>, "Hook must select a basic_list_hook");
+
         public:
             // The type of the elements in the list.
             using value_type = T;
 
-            // The pointer-to-member associated with the list hook object.
-            static constexpr list_hook T::*hook_ptr = Hook;
+            // The type of the list hook object.
+            using hook_type = typename traits::hook_type;
+
+            // The hook selector associated with the list hook object.
+            static constexpr auto hook_ptr = Hook;
+
+            // The link mode of the list hook.
+            static constexpr link_mode mode = hook_type::mode;
+
+            // Whether the list tracks its size (so that size() is constant
+            // time).
+            static constexpr bool constant_time_size = ConstantTimeSize;
+
+            static_assert(!constant_time_size || mode != link_mode::auto_unlink,
+                          "A list of auto-unlink hooks cannot track its size");
 
             // The type of a mutating reference to a node in the list.
             using reference = T&;
@@ -166,17 +268,119 @@ namespace ra::intrusive {
             // must provide all of the functionality of a bidirectional iterator.
             // If desired, the Boost Iterator library may be used to implement
             // this type.
-            using iterator = list_iterator<T>;
+            using iterator = list_iterator<T, Hook>;
 
             // The non-mutating (bidirectional) iterator type for the list. This
             // type must provide all of the functionality of a bidirectional
             // iterator. If desired, the Boost Iterator library may be used to
             // implement this type.
-            using const_iterator = list_iterator<const T>;
+            using const_iterator = list_iterator<const T, Hook>;
 
             // An unsigned integral type used to represent sizes.
             using size_type = std::size_t;
 
+            // A chain of elements linked through their hooks that does not
+            // belong to any list.
+            // A chain can be built without touching any list (e.g., by a producer
+            // before it takes the lock guarding a shared list), and then attached
+            // to a list with insert_chain or push_back_chain, which write only the
+            // two boundary nodes of the list. Auto-unlink hooks cannot be
+            // chained, since a chain has no sentinel node to unlink from.
+            class chain {
+                    static_assert(mode != link_mode::auto_unlink, "Auto-unlink hooks cannot be chained");
+
+                public:
+                    // Default construct a chain.
+                    //
+                    // Creates an empty chain.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    chain() : first_(nullptr), last_(nullptr), size_(0) {}
+
+                    // Destroy a chain.
+                    //
+                    // Erases any elements from the chain.
+                    //
+                    // Time complexity:
+                    // Constant in normal mode; otherwise, linear.
+                    ~chain() {
+                        clear();
+                    }
+
+                    // Do not allow the copying of chains.
+                    chain(const chain&) = delete;
+                    chain& operator=(const chain&) = delete;
+
+                    // Returns the number of elements in the chain.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    size_type size() const {
+                        return size_;
+                    }
+
+                    // Returns true if the chain contains no elements.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    bool empty() const {
+                        return first_ == nullptr;
+                    }
+
+                    // Appends the element x (which must not belong to a list or
+                    // chain) to the chain.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    void push_back(reference x) {
+                        hook_type* node = traits::to_hook(&x);
+
+                        if constexpr (mode != link_mode::normal) {
+                            assert(!node->is_linked());
+                        }
+
+                        node->prev_ = last_;
+                        if (last_) {
+                            last_->next_ = node;
+                        } else {
+                            first_ = node;
+                        }
+                        last_ = node;
+                        ++size_;
+                    }
+
+                    // Erases any elements from the chain, yielding an empty chain.
+                    //
+                    // Time complexity:
+                    // Constant in normal mode; otherwise, linear.
+                    void clear() {
+                        if constexpr (mode != link_mode::normal) {
+                            for (list_node* node = first_; node;) {
+                                list_node* next = node != last_ ? node->next_ : nullptr;
+                                node->next_ = nullptr;
+                                node->prev_ = nullptr;
+                                node = next;
+                            }
+                        }
+                        first_ = nullptr;
+                        last_ = nullptr;
+                        size_ = 0;
+                    }
+
+                private:
+                    friend class list;
+
+                    // The first node in the chain (or null if the chain is
+                    // empty).
+                    list_node* first_;
+                    // The last node in the chain (or null if the chain is
+                    // empty). Its successor is not maintained.
+                    list_node* last_;
+
+                    size_type size_;
+            };
+
             // Default construct a list.
             //
             // Creates an empty list.
@@ -187,7 +391,9 @@ namespace ra::intrusive {
                 sentinel_.next_ = &sentinel_;
                 sentinel_.prev_ = &sentinel_;
 
-                size_ = 0;
+                if constexpr (constant_time_size) {
+                    size_ = 0;
+                }
             }
 
             // Destroy a list.
@@ -208,32 +414,26 @@ namespace ra::intrusive {
             //
             // Time complexity:
             // Constant.
-            list(list&& other) : sentinel_(other.sentinel_), size_(other.size_) {
-                other.sentinel_.next_ = &other.sentinel_;
-                other.sentinel_.prev_ = &other.sentinel_;
-                other.size_ = 0;
+            list(list&& other) : list() {
+                swap(other);
             }
 
             // Move assign a list.
             //
-            // The elements of the source list (i.e., other) are swapped with the
-            // elements of the destination list (i.e., *this). The relative order
-            // of the elements in each list is preserved.
+            // Any elements in the destination list (i.e., *this) are erased, and
+            // the elements of the source list (i.e., other) are then moved to the
+            // destination list, preserving their relative order. After the move,
+            // the source list is empty.
             //
             // Precondition:
             // The objects *this and other are distinct.
             //
             // Time complexity:
-            // Constant.
+            // Either linear or constant.
             list& operator=(list&& other) {
                 if (this != &other) {
                     clear();
-                    sentinel_ = other.sentinel_;
-                    size_ = other.size_;
-
-                    other.sentinel_.next_ = &other.sentinel_;
-                    other.sentinel_.prev_ = &other.sentinel_;
-                    other.size_ = 0;
+                    swap(other);
                 }
                 return *this;
             }
@@ -251,17 +451,48 @@ namespace ra::intrusive {
             // Constant.
             void swap(list& x) {
                 if (this != &x) {
-                    std::swap(sentinel_, x.sentinel_);
-                    std::swap(size_, x.size_);
+                    list_node* first = sentinel_.next_;
+                    list_node* last = sentinel_.prev_;
+                    bool was_empty = first == &sentinel_;
+
+                    if (x.sentinel_.next_ == &x.sentinel_) {
+                        sentinel_.next_ = &sentinel_;
+                        sentinel_.prev_ = &sentinel_;
+                    } else {
+                        link_range(&sentinel_, x.sentinel_.next_, x.sentinel_.prev_);
+                    }
+
+                    if (was_empty) {
+                        x.sentinel_.next_ = &x.sentinel_;
+                        x.sentinel_.prev_ = &x.sentinel_;
+                    } else {
+                        link_range(&x.sentinel_, first, last);
+                    }
+
+                    if constexpr (constant_time_size) {
+                        std::swap(size_, x.size_);
+                    }
                 }
             }
 
             // Returns the number of elements in the list.
             //
             // Time complexity:
-            // Constant.
+            // Constant if constant_time_size is true; otherwise, linear.
             size_type size() const {
-                return size_;
+                if constexpr (constant_time_size) {
+                    return size_;
+                } else {
+                    return static_cast<size_type>(std::distance(begin(), end()));
+                }
+            }
+
+            // Returns true if the list contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return sentinel_.next_ == &sentinel_;
             }
 
             // Inserts an element in the list before the element referred to
@@ -270,14 +501,93 @@ namespace ra::intrusive {
             //
             // Time complexity:
             // Constant.
-            iterator insert(iterator pos, value_type& value) {
-                pos->prev_->next_ = &value;
-                value.hook.next_ = pos;
-                value.hook.prev_ = pos->prev_;
-                pos->prev_ = &value;
-                ++size_;
+            iterator insert(const_iterator pos, value_type& value) {
+                list_node* next = pos.get_node();
+                hook_type* node = traits::to_hook(&value);
+
+                if constexpr (mode != link_mode::normal) {
+                    assert(!node->is_linked());
+                }
+
+                node->next_ = next;
+                node->prev_ = next->prev_;
+                next->prev_->next_ = node;
+                next->prev_ = node;
+                add_size(1);
+
+                return iterator(node);
+            }
+
+            // Inserts the elements referred to by the iterators in the range
+            // [first, last) (in order) before the element referred to by the
+            // iterator pos. The elements are linked to each other before the
+            // range is attached, so the list itself is only written at the two
+            // boundary nodes, and the tracked size is updated once.
+            // An iterator that refers to the first inserted element is returned
+            // if the range is not empty; otherwise, pos is returned.
+            //
+            // Time complexity:
+            // Linear in the number of elements inserted.
+            template <class InputIt>
+            requires std::is_convertible_v<typename std::iterator_traits<InputIt>::reference, reference>
+            iterator insert(const_iterator pos, InputIt first, InputIt last) {
+                list_node* next = pos.get_node();
+                list_node* const before = next->prev_;
+                list_node* prev = before;
+                size_type n = 0;
+
+                for (; first != last; ++first) {
+                    hook_type* node = traits::to_hook(&static_cast<reference>(*first));
+
+                    if constexpr (mode != link_mode::normal) {
+                        assert(!node->is_linked());
+                    }
+
+                    node->prev_ = prev;
+                    prev->next_ = node;
+                    prev = node;
+                    ++n;
+                }
+
+                prev->next_ = next;
+                next->prev_ = prev;
+                add_size(n);
+
+                return iterator(before->next_);
+            }
+
+            // Moves the elements of the chain c before the element referred to
+            // by the iterator pos, preserving their order. After the insertion,
+            // c is empty.
+            //
+            // Time complexity:
+            // Constant.
+            void insert_chain(const_iterator pos, chain& c) {
+                if (c.empty()) {
+                    return;
+                }
+
+                list_node* next = pos.get_node();
+                list_node* prev = next->prev_;
 
-                return iterator(&value);
+                c.first_->prev_ = prev;
+                prev->next_ = c.first_;
+                c.last_->next_ = next;
+                next->prev_ = c.last_;
+                add_size(c.size_);
+
+                c.first_ = nullptr;
+                c.last_ = nullptr;
+                c.size_ = 0;
+            }
+
+            // Moves the elements of the chain c to the end of the list,
+            // preserving their order. After the insertion, c is empty.
+            //
+            // Time complexity:
+            // Constant.
+            void push_back_chain(chain& c) {
+                insert_chain(end(), c);
             }
 
             // Erases the element in the list at the position specified by the
@@ -288,12 +598,19 @@ namespace ra::intrusive {
             //
             // Time complexity:
             // Constant.
-            iterator erase(iterator pos) {
-                pos->prev_->next_ = pos->next_;
-                pos->next_->prev_ = pos->prev_;
-                --size_;
+            iterator erase(const_iterator pos) {
+                list_node* node = pos.get_node();
+                list_node* next = node->next_;
 
-                return iterator(pos->next_);
+                node->prev_->next_ = next;
+                next->prev_ = node->prev_;
+                if constexpr (mode != link_mode::normal) {
+                    node->next_ = nullptr;
+                    node->prev_ = nullptr;
+                }
+                subtract_size(1);
+
+                return iterator(next);
             }
 
             // Inserts the element with the value x at the end of the list.
@@ -312,7 +629,7 @@ namespace ra::intrusive {
             // Time complexity:
             // Constant.
             void pop_back() {
-                if (size_ > 0) {
+                if (!empty()) {
                     erase(--end());
                 }
             }
@@ -332,15 +649,351 @@ namespace ra::intrusive {
             }
 
             // Erases any elements from the list, yielding an empty list.
+            // In normal mode, the erased hooks are not written (as for
+            // unsafe_clear); otherwise, each hook is reset in a single pass.
             //
             // Time complexity:
-            // Either linear or constant.
+            // Constant in normal mode; otherwise, linear.
             void clear() {
-                while (size_ > 0) {
-                    erase(begin());
+                if constexpr (mode == link_mode::normal) {
+                    unsafe_clear();
+                } else {
+                    clear_and_dispose([](value_type&) {});
                 }
             }
 
+            // Erases any elements from the list, yielding an empty list, and
+            // calls disposer(x) for each erased element x in order.
+            // The list is walked once: the successor of each element is read
+            // before the element is disposed, so the disposer may destroy or
+            // reuse the element. In normal mode, the hooks are not written;
+            // otherwise, each hook is reset before its element is disposed.
+            //
+            // Time complexity:
+            // Linear in size().
+            template <class Disposer>
+            void clear_and_dispose(Disposer disposer) {
+                list_node* node = sentinel_.next_;
+                unsafe_clear_links();
+
+                while (node != &sentinel_) {
+                    list_node* next = node->next_;
+                    if constexpr (mode != link_mode::normal) {
+                        node->next_ = nullptr;
+                        node->prev_ = nullptr;
+                    }
+                    disposer(*traits::to_value(static_cast<hook_type*>(node)));
+                    node = next;
+                }
+            }
+
+            // Erases any elements from the list, yielding an empty list,
+            // without visiting the elements. The erased hooks keep their
+            // stale links, which is harmless for normal-mode hooks since they
+            // are never queried or unlinked by themselves.
+            //
+            // Time complexity:
+            // Constant.
+            void unsafe_clear()
+            requires(mode == link_mode::normal)
+            {
+                unsafe_clear_links();
+            }
+
+            // Replaces the element referred to by the iterator replace_this
+            // with the element with_this (which must not belong to a list),
+            // which takes its position in whatever list contains it. Only the
+            // two hooks and the neighbouring nodes are written, so this may be
+            // used to relocate an element (e.g., after it has been moved to
+            // new storage) without access to the list object.
+            //
+            // Time complexity:
+            // Constant.
+            static void replace_node(const_iterator replace_this, reference with_this) {
+                list_node* node = replace_this.get_node();
+                hook_type* with = traits::to_hook(&with_this);
+
+                if constexpr (mode != link_mode::normal) {
+                    assert(!with->is_linked());
+                }
+
+                with->next_ = node->next_;
+                with->prev_ = node->prev_;
+                node->prev_->next_ = with;
+                node->next_->prev_ = with;
+                if constexpr (mode != link_mode::normal) {
+                    node->next_ = nullptr;
+                    node->prev_ = nullptr;
+                }
+            }
+
+            // Moves all of the elements of the list other into *this before
+            // the element referred to by the iterator pos. After the splice,
+            // other is empty. No elements are copied and no iterators or
+            // references are invalidated.
+            //
+            // Precondition:
+            // The objects *this and other are distinct.
+            //
+            // Time complexity:
+            // Constant.
+            void splice(const_iterator pos, list& other) {
+                if (!other.empty()) {
+                    if constexpr (constant_time_size) {
+                        size_ += other.size_;
+                        other.size_ = 0;
+                    }
+                    transfer(pos.get_node(), other.sentinel_.next_, &other.sentinel_);
+                }
+            }
+            void splice(const_iterator pos, list&& other) {
+                splice(pos, other);
+            }
+
+            // Moves the element referred to by the iterator it from the list
+            // other into *this before the element referred to by the iterator
+            // pos. The lists *this and other may be the same list.
+            //
+            // Time complexity:
+            // Constant.
+            void splice(const_iterator pos, list& other, const_iterator it) {
+                list_node* node = it.get_node();
+
+                if (node != pos.get_node() && node->next_ != pos.get_node()) {
+                    transfer(pos.get_node(), node, node->next_);
+                    add_size(1);
+                    other.subtract_size(1);
+                }
+            }
+            void splice(const_iterator pos, list&& other, const_iterator it) {
+                splice(pos, other, it);
+            }
+
+            // Moves the elements in the range [first, last) from the list other
+            // into *this before the element referred to by the iterator pos. The
+            // lists *this and other may be the same list, in which case pos must
+            // not be in the range [first, last).
+            //
+            // Time complexity:
+            // Constant if other is *this or constant_time_size is false;
+            // otherwise, linear in the number of elements moved (which must be
+            // counted). Use the overload taking the count n to make the
+            // operation constant time.
+            void splice(const_iterator pos, list& other, const_iterator first, const_iterator last) {
+                if (this == &other || !constant_time_size) {
+                    transfer(pos.get_node(), first.get_node(), last.get_node());
+                } else {
+                    splice(pos, other, first, last, std::distance(first, last));
+                }
+            }
+            void splice(const_iterator pos, list&& other, const_iterator first, const_iterator last) {
+                splice(pos, other, first, last);
+            }
+
+            // Moves the n elements in the range [first, last) from the list
+            // other into *this before the element referred to by the iterator
+            // pos.
+            //
+            // Precondition:
+            // The range [first, last) contains exactly n elements. If other is
+            // *this, pos is not in the range [first, last).
+            //
+            // Time complexity:
+            // Constant.
+            void splice(const_iterator pos, list& other, const_iterator first, const_iterator last, size_type n) {
+                transfer(pos.get_node(), first.get_node(), last.get_node());
+                if (this != &other) {
+                    add_size(n);
+                    other.subtract_size(n);
+                }
+            }
+            void splice(const_iterator pos, list&& other, const_iterator first, const_iterator last, size_type n) {
+                splice(pos, other, first, last, n);
+            }
+
+            // Merges the sorted list other into the sorted list *this. After the
+            // merge, other is empty and *this is sorted with respect to comp.
+            // The merge is stable: for equivalent elements, the elements from
+            // *this precede the elements from other, and the relative order of
+            // each list is preserved. Merging a list with itself has no effect.
+            //
+            // Precondition:
+            // Both lists are sorted with respect to comp.
+            //
+            // Time complexity:
+            // At most size() + other.size() - 1 comparisons. Runs of elements
+            // from other are moved with a single splice each.
+            template <class Compare>
+            void merge(list& other, Compare comp) {
+                if (this == &other) {
+                    return;
+                }
+
+                list_node* pos = sentinel_.next_;
+                list_node* first = other.sentinel_.next_;
+                list_node* const end = &other.sentinel_;
+
+                while (first != end) {
+                    if (pos == &sentinel_) {
+                        transfer(pos, first, end);
+                        break;
+                    }
+
+                    if (comp(to_value(first), to_value(pos))) {
+                        // Find the run of elements from other that precede pos.
+                        list_node* last = first->next_;
+                        while (last != end && comp(to_value(last), to_value(pos))) {
+                            last = last->next_;
+                        }
+                        transfer(pos, first, last);
+                        first = last;
+                    } else {
+                        pos = pos->next_;
+                    }
+                }
+
+                if constexpr (constant_time_size) {
+                    size_ += other.size_;
+                    other.size_ = 0;
+                }
+            }
+            template <class Compare>
+            void merge(list&& other, Compare comp) {
+                merge(other, comp);
+            }
+            void merge(list& other) {
+                merge(other, std::less<T>());
+            }
+            void merge(list&& other) {
+                merge(other, std::less<T>());
+            }
+
+            // Sorts the elements of the list with respect to comp.
+            // The sort is a bottom-up merge sort that relinks the hooks in
+            // place: it is stable, performs no memory allocation, and does not
+            // invalidate any iterators or references.
+            //
+            // Time complexity:
+            // O(n log n) comparisons, where n is size().
+            template <class Compare>
+            void sort(Compare comp) {
+                if (sentinel_.next_ == sentinel_.prev_) {
+                    return;
+                }
+
+                // Sort the nodes as a null-terminated singly-linked chain, and
+                // then restore the predecessor links in a single pass.
+                sentinel_.prev_->next_ = nullptr;
+                list_node* head = sentinel_.next_;
+
+                for (size_type width = 1;; width *= 2) {
+                    list_node* p = head;
+                    list_node* tail = nullptr;
+                    size_type merges = 0;
+                    head = nullptr;
+
+                    while (p) {
+                        ++merges;
+
+                        // The runs p and q each hold at most width nodes.
+                        list_node* q = p;
+                        size_type p_size = 0;
+                        while (p_size < width && q) {
+                            q = q->next_;
+                            ++p_size;
+                        }
+                        size_type q_size = width;
+
+                        while (p_size > 0 || (q_size > 0 && q)) {
+                            list_node* next;
+                            // Taking from p on ties keeps the sort stable.
+                            if (p_size > 0 && (q_size == 0 || !q || !comp(to_value(q), to_value(p)))) {
+                                next = p;
+                                p = p->next_;
+                                --p_size;
+                            } else {
+                                next = q;
+                                q = q->next_;
+                                --q_size;
+                            }
+
+                            if (tail) {
+                                tail->next_ = next;
+                            } else {
+                                head = next;
+                            }
+                            tail = next;
+                        }
+
+                        p = q;
+                    }
+
+                    tail->next_ = nullptr;
+                    if (merges <= 1) {
+                        break;
+                    }
+                }
+
+                list_node* prev = &sentinel_;
+                for (list_node* node = head; node; node = node->next_) {
+                    node->prev_ = prev;
+                    prev->next_ = node;
+                    prev = node;
+                }
+                prev->next_ = &sentinel_;
+                sentinel_.prev_ = prev;
+            }
+            void sort() {
+                sort(std::less<T>());
+            }
+
+            // Erases all but the first element from every group of consecutive
+            // equivalent elements, where two elements x and y (with x preceding
+            // y) are equivalent if pred(x, y) is true.
+            // The number of elements erased is returned.
+            //
+            // Time complexity:
+            // Linear in size().
+            template <class BinaryPredicate>
+            size_type unique(BinaryPredicate pred) {
+                size_type count = 0;
+
+                if (empty()) {
+                    return count;
+                }
+
+                list_node* first = sentinel_.next_;
+                list_node* next = first->next_;
+                while (next != &sentinel_) {
+                    if (pred(to_value(first), to_value(next))) {
+                        next = erase(const_iterator(next)).get_node();
+                        ++count;
+                    } else {
+                        first = next;
+                        next = next->next_;
+                    }
+                }
+
+                return count;
+            }
+            size_type unique() {
+                return unique(std::equal_to<T>());
+            }
+
+            // Reverses the order of the elements in the list.
+            // No iterators or references are invalidated.
+            //
+            // Time complexity:
+            // Linear in size().
+            void reverse() {
+                list_node* node = &sentinel_;
+                do {
+                    std::swap(node->next_, node->prev_);
+                    // The old successor is now the predecessor.
+                    node = node->prev_;
+                } while (node != &sentinel_);
+            }
+
             // Returns an iterator referring to the first element in the list
             // if the list is not empty and end() otherwise.
             //
@@ -359,16 +1012,108 @@ namespace ra::intrusive {
             // Time complexity:
             // Constant.
             const_iterator end() const {
-                return const_iterator(&sentinel_);
+                return const_iterator(const_cast<list_node*>(&sentinel_));
             }
             iterator end() {
                 return iterator(&sentinel_);
             }
 
+            // Returns an iterator referring to the element value, which must
+            // belong to the list. The hook of value is located through the
+            // hook selector Hook, so no list traversal is needed.
+            //
+            // Time complexity:
+            // Constant.
+            iterator iterator_to(reference value) {
+                return s_iterator_to(value);
+            }
+            const_iterator iterator_to(const_reference value) const {
+                return s_iterator_to(value);
+            }
+
+            // Returns an iterator referring to the element value, which must
+            // belong to a list of this type. Unlike iterator_to, this function
+            // does not require access to the list object.
+            //
+            // Time complexity:
+            // Constant.
+            static iterator s_iterator_to(reference value) {
+                return iterator(traits::to_hook(&value));
+            }
+            static const_iterator s_iterator_to(const_reference value) {
+                return const_iterator(const_cast<hook_type*>(traits::to_hook(&value)));
+            }
+
         private:
+            // The placeholder for size_ when the size is not tracked.
+            struct no_size {};
+
+            // Adds n to the tracked size of the list.
+            void add_size([[maybe_unused]] size_type n) {
+                if constexpr (constant_time_size) {
+                    size_ += n;
+                }
+            }
+
+            // Subtracts n from the tracked size of the list.
+            void subtract_size([[maybe_unused]] size_type n) {
+                if constexpr (constant_time_size) {
+                    size_ -= n;
+                }
+            }
+
+            // Makes the sentinel node refer to itself and zeroes the tracked
+            // size, without visiting the elements.
+            void unsafe_clear_links() {
+                sentinel_.next_ = &sentinel_;
+                sentinel_.prev_ = &sentinel_;
+                if constexpr (constant_time_size) {
+                    size_ = 0;
+                }
+            }
+
+            // Returns the element containing the hook node.
+            static const T& to_value(const list_node* node) {
+                return *traits::to_value(static_cast<const hook_type*>(node));
+            }
+
+            // Makes the chain of nodes [first, last] the contents of the list
+            // whose sentinel node is sentinel.
+            static void link_range(list_node* sentinel, list_node* first, list_node* last) {
+                sentinel->next_ = first;
+                sentinel->prev_ = last;
+                first->prev_ = sentinel;
+                last->next_ = sentinel;
+            }
+
+            // Unlinks the nodes in the range [first, last) and relinks them
+            // before the node pos. Only the nodes at the boundaries of the
+            // range are written.
+            static void transfer(list_node* pos, list_node* first, list_node* last) {
+                if (first == last || pos == last) {
+                    return;
+                }
+
+                list_node* tail = last->prev_;
+
+                // Detach [first, last) from its current position.
+                first->prev_->next_ = last;
+                last->prev_ = first->prev_;
+
+                // Attach [first, tail] before pos.
+                pos->prev_->next_ = first;
+                first->prev_ = pos->prev_;
+                tail->next_ = pos;
+                pos->prev_ = tail;
+            }
+
             // The sentinel node.
-            list_hook sentinel_;
+            list_node sentinel_;
 
-            size_type size_;
+            // The number of elements (only tracked if constant_time_size is
+            // true).
+            [[no_unique_address]] std::conditional_t<constant_time_size, size_type, no_size> size_;
     };
-}  // namespace ra::intrusive
\ No newline at end of file
+}  // namespace ra::intrusive
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef ra_intrusive_list_arena_hpp
+#define ra_intrusive_list_arena_hpp
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ra/intrusive_list.hpp>
+#include <utility>
+#include <vector>
+
+namespace ra::intrusive {
+    // Compacting slab of list elements.
+    //
+    // This class owns a fixed-capacity array of slots for objects of type T
+    // that are linked into lists through the list hook selected by Hook.
+    // Objects are created and destroyed in the arena individually (in any
+    // order), and a list of arena objects can be compacted so that its
+    // elements occupy consecutive slots in list order, which makes a
+    // traversal of the list sequential in memory.
+    //
+    // Compaction is incremental: each call to compact_for or compact_steps
+    // does a bounded amount of work and resumes where the previous call
+    // stopped. An element is relocated by move constructing it into its new
+    // slot, transferring its list links (see list::replace_node), and
+    // destroying the old object. An optional callback is then told the old
+    // and new addresses so that any outside pointers can be patched.
+    //
+    // Precondition (for compaction):
+    // Every live object in the arena is linked (through Hook) into some list
+    // whenever compaction runs, since an object occupying a slot that is
+    // needed for the compacted list is relocated as well. Between the calls
+    // of a compaction pass, elements may be inserted into the list being
+    // compacted, but an element may only be erased from it if it is then
+    // destroyed (or restart_compaction is called).
+    template <class T, auto Hook>
+    class list_arena {
+        public:
+            // The type of the objects in the arena.
+            using value_type = T;
+
+            // The type of the lists that link the objects.
+            using list_type = list<T, Hook>;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Construct an arena.
+            //
+            // Creates an empty arena with room for capacity objects.
+            //
+            // Time complexity:
+            // Linear in capacity.
+            explicit list_arena(size_type capacity)
+                : slots_(std::make_unique<slot[]>(capacity + 1)),
+                  live_(capacity, false),
+                  capacity_(capacity),
+                  size_(0),
+                  cursor_(0) {
+                free_.reserve(capacity);
+                for (size_type i = capacity; i > 0; --i) {
+                    free_.push_back(i - 1);
+                }
+            }
+
+            // Destroy an arena.
+            //
+            // Destroys any objects remaining in the arena, which must not belong
+            // to a list.
+            //
+            // Time complexity:
+            // Linear in capacity().
+            ~list_arena() {
+                for (size_type i = 0; i < capacity_; ++i) {
+                    if (live_[i]) {
+                        at(i)->~T();
+                    }
+                }
+            }
+
+            // Do not allow the copying of arenas.
+            list_arena(const list_arena&) = delete;
+            list_arena& operator=(const list_arena&) = delete;
+
+            // Returns the number of objects the arena can hold.
+            //
+            // Time complexity:
+            // Constant.
+            size_type capacity() const {
+                return capacity_;
+            }
+
+            // Returns the number of live objects in the arena.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the arena holds the object x.
+            //
+            // Time complexity:
+            // Constant.
+            bool contains(const T& x) const {
+                const slot* s = reinterpret_cast<const slot*>(&x);
+                return s >= slots_.get() && s < slots_.get() + capacity_;
+            }
+
+            // Constructs an object from args in a free slot of the arena.
+            // A pointer to the new object is returned, or null if the arena is
+            // full.
+            //
+            // Time complexity:
+            // Amortized constant.
+            template <class... Args>
+            T* create(Args&&... args) {
+                // Compaction may fill a slot without removing it from the free
+                // stack, so stale entries are skipped here.
+                while (!free_.empty() && live_[free_.back()]) {
+                    free_.pop_back();
+                }
+                if (free_.empty()) {
+                    return nullptr;
+                }
+
+                size_type index = free_.back();
+                T* x = ::new (static_cast<void*>(at(index))) T(std::forward<Args>(args)...);
+                free_.pop_back();
+                live_[index] = true;
+                ++size_;
+                return x;
+            }
+
+            // Destroys the object x, which must have been created in the arena
+            // and must not belong to a list.
+            //
+            // Time complexity:
+            // Constant.
+            void destroy(T& x) {
+                size_type index = index_of(x);
+                assert(live_[index]);
+
+                x.~T();
+                release(index);
+                if (index < cursor_) {
+                    // The element may have been part of the compacted prefix.
+                    cursor_ = 0;
+                }
+            }
+
+            // Compacts the list l, visiting at most steps of its elements, and
+            // calls on_relocate(from, to) after the object formerly at the
+            // address from (which may since hold another object) is relocated
+            // to the object to. A pass ends once the elements of l
+            // occupy the slots [0, l.size()) in list order, after which the
+            // next call starts a new pass.
+            // Returns true if the pass has ended.
+            //
+            // Precondition:
+            // All of the elements of l reside in the arena.
+            //
+            // Time complexity:
+            // Linear in steps (plus, when resuming a pass, constant).
+            template <class OnRelocate>
+            bool compact_steps(list_type& l, size_type steps, OnRelocate on_relocate) {
+                return compact(l, on_relocate, [&steps](size_type done) { return done < steps; });
+            }
+            bool compact_steps(list_type& l, size_type steps) {
+                return compact_steps(l, steps, [](const T*, T&) {});
+            }
+
+            // Compacts the list l as for compact_steps, but stops after roughly
+            // the time budget has elapsed (instead of after a number of steps).
+            // Returns true if the pass has ended.
+            template <class Rep, class Period, class OnRelocate>
+            bool compact_for(list_type& l, std::chrono::duration<Rep, Period> budget, OnRelocate on_relocate) {
+                auto deadline = std::chrono::steady_clock::now() + budget;
+                return compact(l, on_relocate, [deadline](size_type done) {
+                    // Only read the clock every few steps.
+                    return done % 16 != 0 || std::chrono::steady_clock::now() < deadline;
+                });
+            }
+            template <class Rep, class Period>
+            bool compact_for(list_type& l, std::chrono::duration<Rep, Period> budget) {
+                return compact_for(l, budget, [](const T*, T&) {});
+            }
+
+            // Abandons the current compaction pass, so that the next
+            // compaction starts from the beginning of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void restart_compaction() {
+                cursor_ = 0;
+            }
+
+        private:
+            // Uninitialized storage for one object.
+            struct slot {
+                alignas(T) unsigned char bytes[sizeof(T)];
+            };
+
+            // Returns the object storage of the slot with the index index.
+            T* at(size_type index) {
+                return std::launder(reinterpret_cast<T*>(slots_[index].bytes));
+            }
+
+            // Returns the index of the slot holding the object x.
+            size_type index_of(const T& x) const {
+                assert(contains(x));
+                return static_cast<size_type>(reinterpret_cast<const slot*>(&x) - slots_.get());
+            }
+
+            // Marks the slot with the index index as free.
+            void release(size_type index) {
+                live_[index] = false;
+                free_.push_back(index);
+                --size_;
+
+                // Discard the stale entries once they outnumber the live ones.
+                if (free_.size() > 2 * (capacity_ - size_)) {
+                    free_.clear();
+                    for (size_type i = capacity_; i > 0; --i) {
+                        if (!live_[i - 1]) {
+                            free_.push_back(i - 1);
+                        }
+                    }
+                }
+            }
+
+            // Moves the (linked) object from to the storage to, and returns the
+            // new object.
+            static T& relocate(T& from, T* to) {
+                T* x = ::new (static_cast<void*>(to)) T(std::move(from));
+                list_type::replace_node(list_type::s_iterator_to(from), *x);
+                from.~T();
+                return *x;
+            }
+
+            // Runs the current compaction pass until it ends or more(n) is
+            // false, where n is the number of steps done by this call.
+            template <class OnRelocate, class More>
+            bool compact(list_type& l, OnRelocate& on_relocate, More more) {
+                // Resume after the last element settled by the previous call.
+                typename list_type::iterator it =
+                    cursor_ == 0 ? l.begin() : std::next(list_type::s_iterator_to(*at(cursor_ - 1)));
+
+                for (size_type done = 0; it != l.end(); ++done) {
+                    if (!more(done)) {
+                        return false;
+                    }
+
+                    size_type from = index_of(*it);
+                    if (from < cursor_) {
+                        // The element was inserted into l behind the cursor
+                        // after its slot was settled; leave it for the next
+                        // pass.
+                        ++it;
+                        continue;
+                    }
+
+                    if (from != cursor_) {
+                        T* old = &*it;
+                        if (live_[cursor_]) {
+                            // Swap the occupant of the target slot with the
+                            // element, through the spare slot.
+                            T* other = at(cursor_);
+                            T& spare = relocate(*other, at(capacity_));
+                            T& x = relocate(*old, other);
+                            T& y = relocate(spare, old);
+                            on_relocate(other, y);
+                            on_relocate(old, x);
+                        } else {
+                            T& x = relocate(*old, at(cursor_));
+                            live_[cursor_] = true;
+                            ++size_;
+                            release(from);
+                            on_relocate(old, x);
+                        }
+                        it = list_type::s_iterator_to(*at(cursor_));
+                    }
+
+                    ++cursor_;
+                    ++it;
+                }
+
+                cursor_ = 0;
+                return true;
+            }
+
+            // The slots (followed by a spare slot used when swapping objects).
+            std::unique_ptr<slot[]> slots_;
+
+            // Whether each slot holds a live object.
+            std::vector<bool> live_;
+
+            // The indices of the free slots (possibly including stale entries
+            // for slots that compaction has since filled).
+            std::vector<size_type> free_;
+
+            size_type capacity_;
+
+            size_type size_;
+
+            // The number of slots settled by the current compaction pass.
+            size_type cursor_;
+    };
+}  // namespace ra::intrusive
+
+#endif
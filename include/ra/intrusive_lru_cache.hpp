@@ -0,0 +1,313 @@
+#ifndef ra_intrusive_lru_cache_hpp
+#define ra_intrusive_lru_cache_hpp
+
+#include <cstddef>
+#include <functional>
+#include <ra/intrusive_hook_traits.hpp>
+#include <ra/intrusive_list.hpp>
+#include <ra/intrusive_unordered_set.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    template <class T, class KeyOf, auto ListHook, auto IndexHook, class Hash, class KeyEqual>
+    class lru_cache;
+
+    namespace detail {
+        // The key type extracted from a T by a KeyOf function object.
+        template <class KeyOf, class T>
+        using key_of_t = std::remove_cvref_t<std::invoke_result_t<const KeyOf&, const T&>>;
+    }  // namespace detail
+
+    // Per-node cache index information class.
+    // This type is the unordered set hook (with a stored hash) that links an
+    // element into the hash index of an lru_cache, extended with the
+    // referenced bit used for deferred promotion. This class has the
+    // lru_cache class template as a friend.
+    class lru_cache_hook : public basic_unordered_set_hook<true> {
+        public:
+            // Default construct a cache hook.
+            // This constructor creates a cache hook that does not belong to any
+            // cache.
+            lru_cache_hook() : referenced_(false) {}
+
+            // Copy construct a cache hook.
+            // This constructor creates a cache hook that does not belong to any
+            // cache. The argument to the constructor is ignored.
+            lru_cache_hook(const lru_cache_hook&) : lru_cache_hook() {}
+
+            // Copy assign a cache hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            lru_cache_hook& operator=(const lru_cache_hook&) { return *this; }
+
+            // Destroy a cache hook.
+            // The cache hook being destroyed must not belong to a cache. If the
+            // cache hook belongs to a cache, the resulting behavior is undefined.
+            ~lru_cache_hook() = default;
+
+        private:
+            // Whether the element has been hit since it was last promoted.
+            bool referenced_;
+
+            // Friend the lru_cache class template.
+            template <class T, class K, auto L, auto I, class H, class E>
+            friend class lru_cache;
+    };
+
+    // Intrusive least-recently-used cache.
+    //
+    // The cache indexes elements of type T by the key extracted with KeyOf.
+    // Each element embeds two hooks: the list_hook selected by ListHook,
+    // which links the elements in recency order, and the lru_cache_hook
+    // selected by IndexHook, which links the elements into an intrusive
+    // unordered_set used as the hash index. The bucket array is allocated
+    // when the cache is constructed (and is only reallocated if the cache
+    // grows beyond its capacity); no other operation allocates memory.
+    //
+    // A hit through get does not relink the element. It only sets the
+    // referenced bit of the element, and the promotion is deferred until the
+    // element reaches the least-recently-used end of the list, where evict
+    // gives it a second chance (as in the CLOCK algorithm). Hot elements are
+    // therefore promoted at most once per pass of the eviction hand rather
+    // than on every hit. Use touch to promote an element immediately.
+    //
+    // The cache does not own its elements: evict and erase hand elements
+    // back to the caller, which is responsible for their storage.
+    template <class T, class KeyOf, auto ListHook, auto IndexHook, class Hash = std::hash<detail::key_of_t<KeyOf, T>>,
+              class KeyEqual = std::equal_to<detail::key_of_t<KeyOf, T>>>
+    class lru_cache {
+            // The conversions between index hooks and elements.
+            using index_traits = hook_traits<T, IndexHook>;
+
+            using node = lru_cache_hook;
+
+            static_assert(std::is_same_v<typename index_traits::hook_type, node>,
+                          "IndexHook must select an lru_cache_hook");
+
+            // The recency list (least recently used first).
+            using list_type = list<T, ListHook>;
+
+            // Hashes an element by its key.
+            struct element_hash {
+                std::size_t operator()(const T& x) const {
+                    return hash(key_of(x));
+                }
+
+                [[no_unique_address]] Hash hash;
+                [[no_unique_address]] KeyOf key_of;
+            };
+
+            // Compares two elements by their keys.
+            struct element_equal {
+                bool operator()(const T& x, const T& y) const {
+                    return equal(key_of(x), key_of(y));
+                }
+
+                [[no_unique_address]] KeyEqual equal;
+                [[no_unique_address]] KeyOf key_of;
+            };
+
+            // The hash index.
+            using index_type = unordered_set<T, IndexHook, element_hash, element_equal>;
+
+        public:
+            // The type of the elements in the cache.
+            using value_type = T;
+
+            // The type of the keys of the elements.
+            using key_type = detail::key_of_t<KeyOf, T>;
+
+            // The type of a mutating reference to an element in the cache.
+            using reference = T&;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Construct a cache.
+            //
+            // Creates an empty cache that is full once it holds capacity
+            // elements. The hash index has (at least) capacity buckets.
+            //
+            // Time complexity:
+            // Linear in capacity.
+            explicit lru_cache(size_type capacity, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                               const KeyOf& key_of = KeyOf())
+                : index_(capacity, element_hash{hash, key_of}, element_equal{equal, key_of}),
+                  capacity_(capacity),
+                  hash_(hash),
+                  equal_(equal),
+                  key_of_(key_of) {}
+
+            // Destroy a cache.
+            //
+            // Erases any elements from the cache and then destroys the cache.
+            //
+            // Time complexity:
+            // Linear in size().
+            ~lru_cache() {
+                clear();
+            }
+
+            // Do not allow the copying of caches.
+            lru_cache(const lru_cache&) = delete;
+            lru_cache& operator=(const lru_cache&) = delete;
+
+            // Returns the number of elements in the cache.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return index_.size();
+            }
+
+            // Returns the number of elements the cache holds when it is full.
+            //
+            // Time complexity:
+            // Constant.
+            size_type capacity() const {
+                return capacity_;
+            }
+
+            // Returns true if the cache contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return index_.empty();
+            }
+
+            // Returns true if the cache holds at least capacity() elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool full() const {
+                return index_.size() >= capacity_;
+            }
+
+            // Finds the element with the key k without affecting its recency.
+            // A pointer to the element is returned, or null if there is no such
+            // element.
+            //
+            // Time complexity:
+            // Constant on average.
+            T* find(const key_type& k) const {
+                auto it = index_.find(k, hash_, [this](const key_type& key, const T& x) {
+                    return equal_(key, key_of_(x));
+                });
+                return it != index_.end() ? const_cast<T*>(&*it) : nullptr;
+            }
+
+            // Finds the element with the key k and records a hit on it.
+            // The element is not relinked; its promotion is deferred until it
+            // is next considered for eviction.
+            // A pointer to the element is returned, or null if there is no such
+            // element.
+            //
+            // Time complexity:
+            // Constant on average.
+            T* get(const key_type& k) {
+                T* x = find(k);
+                if (x) {
+                    node* n = index_traits::to_hook(x);
+                    // Avoid dirtying the cache line on repeated hits.
+                    if (!n->referenced_) {
+                        n->referenced_ = true;
+                    }
+                }
+                return x;
+            }
+
+            // Makes the element x (which must belong to the cache) the most
+            // recently used element immediately.
+            //
+            // Time complexity:
+            // Constant.
+            void touch(reference x) {
+                index_traits::to_hook(&x)->referenced_ = false;
+                recency_.splice(recency_.end(), recency_, list_type::s_iterator_to(x));
+            }
+
+            // Inserts the element x as the most recently used element.
+            // If an element with an equivalent key is already in the cache, no
+            // insertion is performed. The cache may hold more than capacity()
+            // elements; callers that need a bound should call evict while the
+            // cache is full before inserting.
+            //
+            // Return value:
+            // The second component of the returned pair is true if and only if
+            // the insertion takes place; and the first component refers to
+            // the element with a key equivalent to the key of x.
+            //
+            // Time complexity:
+            // Constant on average.
+            std::pair<T*, bool> insert(reference x) {
+                auto [it, inserted] = index_.insert(x);
+                if (inserted) {
+                    index_traits::to_hook(&x)->referenced_ = false;
+                    recency_.push_back(x);
+                }
+
+                return std::make_pair(&*it, inserted);
+            }
+
+            // Evicts the least recently used element.
+            // Elements with a deferred hit are promoted to most recently used
+            // (and their hit is cleared) instead of being evicted.
+            // A pointer to the evicted element is returned, or null if the cache
+            // is empty.
+            //
+            // Time complexity:
+            // Amortized constant (each element is promoted at most once per
+            // recorded hit).
+            T* evict() {
+                while (!recency_.empty()) {
+                    T& x = *recency_.begin();
+                    node* n = index_traits::to_hook(&x);
+
+                    if (n->referenced_) {
+                        n->referenced_ = false;
+                        recency_.splice(recency_.end(), recency_, recency_.begin());
+                    } else {
+                        erase(x);
+                        return &x;
+                    }
+                }
+                return nullptr;
+            }
+
+            // Erases the element x (which must belong to the cache).
+            //
+            // Time complexity:
+            // Constant on average.
+            void erase(reference x) {
+                index_.erase(x);
+                recency_.erase(list_type::s_iterator_to(x));
+            }
+
+            // Erases any elements from the cache, yielding an empty cache.
+            //
+            // Time complexity:
+            // Linear in size().
+            void clear() {
+                while (!recency_.empty()) {
+                    erase(*recency_.begin());
+                }
+            }
+
+        private:
+            // The elements in recency order (least recently used first).
+            list_type recency_;
+
+            // The elements indexed by key.
+            index_type index_;
+
+            size_type capacity_;
+
+            [[no_unique_address]] Hash hash_;
+            [[no_unique_address]] KeyEqual equal_;
+            [[no_unique_address]] KeyOf key_of_;
+    };
+}  // namespace ra::intrusive
+
+#endif
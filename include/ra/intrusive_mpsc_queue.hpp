@@ -0,0 +1,211 @@
+#ifndef ra_intrusive_mpsc_queue_hpp
+#define ra_intrusive_mpsc_queue_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+
+namespace ra::intrusive {
+    template <class T, auto Hook>
+    class mpsc_queue;
+
+    // Per-node queue management information class.
+    // This type contains the (atomic) pointer to the successor of a node in
+    // an mpsc_queue. This class has the mpsc_queue class template as a friend.
+    class mpsc_queue_hook {
+        public:
+            // Default construct a queue hook.
+            // This constructor creates a queue hook that does not belong to any
+            // queue.
+            mpsc_queue_hook() : next_(nullptr) {}
+
+            // Copy construct a queue hook.
+            // This constructor creates a queue hook that does not belong to any
+            // queue. The argument to the constructor is ignored.
+            mpsc_queue_hook(const mpsc_queue_hook&) : next_(nullptr) {}
+
+            // Copy assign a queue hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            mpsc_queue_hook& operator=(const mpsc_queue_hook&) { return *this; }
+
+            // Destroy a queue hook.
+            // The queue hook being destroyed must not belong to a queue. If the
+            // queue hook belongs to a queue, the resulting behavior is undefined.
+            ~mpsc_queue_hook() = default;
+
+        private:
+            // The next node in the queue (i.e., the node pushed after this one).
+            std::atomic<mpsc_queue_hook*> next_;
+
+            // Friend the mpsc_queue class template.
+            template <class T, auto H>
+            friend class mpsc_queue;
+    };
+
+    // Intrusive multiple-producer single-consumer queue.
+    //
+    // This is the non-blocking intrusive queue of D. Vyukov. The queue holds
+    // a stub node, and elements are linked in FIFO order through the
+    // mpsc_queue_hook selected by Hook (see hook_traits). No memory is ever
+    // allocated by the queue.
+    //
+    // Any number of threads may call push concurrently. Only one thread at a
+    // time (the consumer) may call pop, pop_all and empty.
+    //
+    // Progress:
+    // push is wait-free (one atomic exchange and one store). pop is lock-free
+    // with one caveat: a producer that has exchanged the head but not yet
+    // linked its node makes the elements behind it temporarily invisible, in
+    // which case pop returns null even though the queue is not empty.
+    template <class T, auto Hook>
+    class mpsc_queue {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using node = mpsc_queue_hook;
+
+            static_assert(std::is_same_v<typename traits::hook_type, node>, "Hook must select an mpsc_queue_hook");
+
+        public:
+            // The type of the elements in the queue.
+            using value_type = T;
+
+            // The type of a mutating reference to an element in the queue.
+            using reference = T&;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a queue.
+            //
+            // Creates an empty queue.
+            //
+            // Time complexity:
+            // Constant.
+            mpsc_queue() : head_(&stub_), tail_(&stub_) {}
+
+            // Destroy a queue.
+            //
+            // The elements still in the queue are simply abandoned (i.e., their
+            // hooks are left linked).
+            //
+            // Time complexity:
+            // Constant.
+            ~mpsc_queue() = default;
+
+            // Do not allow the copying or moving of queues (since producers may
+            // refer to the queue concurrently).
+            mpsc_queue(const mpsc_queue&) = delete;
+            mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+            // Appends the element x to the queue.
+            // This function may be called concurrently by any number of threads.
+            //
+            // Time complexity:
+            // Constant (wait-free).
+            void push(reference x) {
+                push_node(traits::to_hook(&x));
+            }
+
+            // Removes the element at the front of the queue.
+            // A pointer to the removed element is returned, or null if no
+            // element is (visibly) available.
+            //
+            // Time complexity:
+            // Constant.
+            T* pop() {
+                node* tail = tail_;
+                node* next = tail->next_.load(std::memory_order_acquire);
+
+                // Skip over the stub node.
+                if (tail == &stub_) {
+                    if (!next) {
+                        return nullptr;
+                    }
+                    tail_ = next;
+                    tail = next;
+                    next = next->next_.load(std::memory_order_acquire);
+                }
+
+                if (next) {
+                    tail_ = next;
+                    return traits::to_value(tail);
+                }
+
+                // The tail is the last linked node. If it is not also the head,
+                // a producer is between its exchange and its link.
+                if (tail != head_.load(std::memory_order_acquire)) {
+                    return nullptr;
+                }
+
+                // Reinsert the stub node behind the tail so that the tail can
+                // be detached.
+                push_node(&stub_);
+
+                next = tail->next_.load(std::memory_order_acquire);
+                if (next) {
+                    tail_ = next;
+                    return traits::to_value(tail);
+                }
+
+                return nullptr;
+            }
+
+            // Removes all of the (visibly) available elements from the queue,
+            // in FIFO order, passing each to the function object f. The
+            // element is no longer referenced by the queue when f is called,
+            // so f may dispose of it.
+            // The number of elements removed is returned.
+            //
+            // Time complexity:
+            // Linear in the number of elements removed.
+            template <class F>
+            size_type pop_all(F f) {
+                size_type count = 0;
+                while (T* x = pop()) {
+                    f(*x);
+                    ++count;
+                }
+                return count;
+            }
+
+            // Returns true if the queue contains no (visibly) available
+            // elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                const node* tail = tail_;
+                if (tail == &stub_) {
+                    return stub_.next_.load(std::memory_order_acquire) == nullptr &&
+                           head_.load(std::memory_order_acquire) == &stub_;
+                }
+                return false;
+            }
+
+        private:
+            // Links the node n at the head of the queue.
+            void push_node(node* n) {
+                n->next_.store(nullptr, std::memory_order_relaxed);
+                node* prev = head_.exchange(n, std::memory_order_acq_rel);
+                prev->next_.store(n, std::memory_order_release);
+            }
+
+            // The size of a cache line (used to keep the producer and
+            // consumer sides of the queue apart).
+            static constexpr std::size_t cache_line_size = 64;
+
+            // The most recently pushed node (written by producers).
+            alignas(cache_line_size) std::atomic<node*> head_;
+
+            // The oldest node (only accessed by the consumer).
+            alignas(cache_line_size) node* tail_;
+
+            // The stub node, which keeps the queue non-empty.
+            node stub_;
+    };
+}  // namespace ra::intrusive
+
+#endif
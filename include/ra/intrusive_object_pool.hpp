@@ -0,0 +1,341 @@
+#ifndef ra_intrusive_object_pool_hpp
+#define ra_intrusive_object_pool_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <ra/intrusive_list.hpp>
+#include <ra/intrusive_slist.hpp>
+#include <utility>
+#include <vector>
+
+namespace ra::intrusive {
+    // Fixed-size object pool with per-thread magazine caches.
+    //
+    // The pool carves objects of type T out of slabs of SlabSize bytes
+    // (each aligned to SlabSize, so the slab of an object is found by
+    // masking its address). A free object slot holds an slist_hook, so free
+    // slots are chained together without any memory besides the slots.
+    //
+    // Objects are created and destroyed through a cache, which each thread
+    // owns privately. A cache holds up to two magazines (chains of at most
+    // magazine_size() free slots), so creation and destruction pop or push
+    // a slot without any locking or atomic operations. Only when both
+    // magazines of a cache are empty (or full) does the cache exchange a
+    // whole magazine with the depot of the pool, under the pool mutex. The
+    // depot obtains new slabs from the system as needed, and trim returns
+    // every slab whose slots are all free in the depot.
+    //
+    // An object may be destroyed through a different cache (or thread) than
+    // the one that created it.
+    template <class T, std::size_t SlabSize = 64 * 1024>
+    class object_pool {
+            // A free slot.
+            struct free_node : slist_hook {};
+
+            // A chain of free slots.
+            using magazine = slist<free_node, base_hook<slist_hook>, false>;
+
+            // The header at the start of each slab.
+            struct slab : list_hook {
+                // The number of free slots of the slab found by trim.
+                std::size_t free_count;
+            };
+
+            // The size and alignment of a slot.
+            static constexpr std::size_t slot_align = std::max(alignof(T), alignof(free_node));
+            static constexpr std::size_t slot_size =
+                (std::max(sizeof(T), sizeof(free_node)) + slot_align - 1) / slot_align * slot_align;
+
+            // The offset of the first slot in a slab.
+            static constexpr std::size_t first_slot = (sizeof(slab) + slot_align - 1) / slot_align * slot_align;
+
+            static_assert((SlabSize & (SlabSize - 1)) == 0, "SlabSize must be a power of two");
+            static_assert(first_slot + slot_size <= SlabSize, "SlabSize must hold at least one object");
+
+        public:
+            // The type of the objects in the pool.
+            using value_type = T;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The number of objects in each slab.
+            static constexpr size_type objects_per_slab = (SlabSize - first_slot) / slot_size;
+
+            class cache;
+
+            // Construct a pool.
+            //
+            // Creates a pool without any slabs, whose caches exchange
+            // magazines of magazine_size slots with the depot.
+            //
+            // Time complexity:
+            // Constant.
+            explicit object_pool(size_type magazine_size = 32) : magazine_size_(std::max<size_type>(magazine_size, 1)) {}
+
+            // Destroy a pool.
+            //
+            // Returns all of the slabs of the pool to the system. All of the
+            // objects of the pool must have been destroyed, and all of its
+            // caches must have been destroyed.
+            //
+            // Time complexity:
+            // Linear in the number of slots.
+            ~object_pool() {
+                // The magazines walk their slots, so they go before the slabs.
+                depot_.clear();
+                slabs_.clear_and_dispose([](slab& s) { free_slab(&s); });
+            }
+
+            // Do not allow the copying of pools.
+            object_pool(const object_pool&) = delete;
+            object_pool& operator=(const object_pool&) = delete;
+
+            // Returns the number of slots in each magazine.
+            //
+            // Time complexity:
+            // Constant.
+            size_type magazine_size() const {
+                return magazine_size_;
+            }
+
+            // Returns the number of slabs obtained from the system.
+            //
+            // Time complexity:
+            // Constant.
+            size_type slab_count() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return slabs_.size();
+            }
+
+            // Returns to the system every slab all of whose slots are free in
+            // the depot. Slots held in caches are not considered, so a thread
+            // should flush its cache first if it has gone idle.
+            // The number of slabs released is returned.
+            //
+            // Time complexity:
+            // Linear in the number of free slots in the depot plus the number of
+            // slabs.
+            size_type trim() {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                for (slab& s : slabs_) {
+                    s.free_count = 0;
+                }
+                for (magazine& m : depot_) {
+                    for (free_node& n : m) {
+                        ++slab_of(&n)->free_count;
+                    }
+                }
+
+                // Rebuild the depot from the slots of the slabs that are kept.
+                std::vector<magazine> kept;
+                magazine m;
+                for (magazine& old : depot_) {
+                    while (!old.empty()) {
+                        free_node& n = old.front();
+                        old.pop_front();
+                        if (slab_of(&n)->free_count != objects_per_slab) {
+                            m.push_front(n);
+                            if (m.size() == magazine_size_) {
+                                kept.push_back(std::move(m));
+                            }
+                        }
+                    }
+                }
+                if (!m.empty()) {
+                    kept.push_back(std::move(m));
+                }
+                depot_.swap(kept);
+
+                size_type released = 0;
+                for (auto it = slabs_.begin(); it != slabs_.end();) {
+                    slab& s = *it;
+                    if (s.free_count == objects_per_slab) {
+                        it = slabs_.erase(it);
+                        free_slab(&s);
+                        ++released;
+                    } else {
+                        ++it;
+                    }
+                }
+                return released;
+            }
+
+            // Per-thread object cache.
+            // A cache must only be used by one thread at a time, and must be
+            // destroyed before its pool.
+            class cache {
+                public:
+                    // Construct a cache of the pool p.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    explicit cache(object_pool& p) : pool_(&p) {}
+
+                    // Destroy a cache.
+                    //
+                    // Returns the free slots of the cache to the depot.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    ~cache() {
+                        flush();
+                    }
+
+                    // Do not allow the copying of caches.
+                    cache(const cache&) = delete;
+                    cache& operator=(const cache&) = delete;
+
+                    // Constructs an object from args in a slot of the pool.
+                    // A pointer to the new object is returned. If the system cannot
+                    // supply a new slab, std::bad_alloc is thrown.
+                    //
+                    // Time complexity:
+                    // Constant (amortized over a magazine when the depot is used).
+                    template <class... Args>
+                    T* create(Args&&... args) {
+                        void* p = allocate();
+                        try {
+                            return ::new (p) T(std::forward<Args>(args)...);
+                        } catch (...) {
+                            deallocate(p);
+                            throw;
+                        }
+                    }
+
+                    // Destroys the object x, which must have been created by a
+                    // cache of the same pool.
+                    //
+                    // Time complexity:
+                    // Constant (amortized over a magazine when the depot is used).
+                    void destroy(T* x) {
+                        x->~T();
+                        deallocate(x);
+                    }
+
+                    // Returns the free slots of the cache to the depot.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    void flush() {
+                        if (!loaded_.empty() || !spare_.empty()) {
+                            std::lock_guard<std::mutex> lock(pool_->mutex_);
+                            pool_->put_magazine(loaded_);
+                            pool_->put_magazine(spare_);
+                        }
+                    }
+
+                    // Returns the number of free slots held by the cache.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    size_type size() const {
+                        return loaded_.size() + spare_.size();
+                    }
+
+                private:
+                    // Returns a free slot.
+                    void* allocate() {
+                        if (loaded_.empty()) {
+                            if (!spare_.empty()) {
+                                loaded_.swap(spare_);
+                            } else {
+                                pool_->get_magazine(loaded_);
+                            }
+                        }
+                        free_node* n = &loaded_.front();
+                        loaded_.pop_front();
+                        return n;
+                    }
+
+                    // Frees the slot p.
+                    void deallocate(void* p) {
+                        if (loaded_.size() == pool_->magazine_size_) {
+                            if (!spare_.empty()) {
+                                std::lock_guard<std::mutex> lock(pool_->mutex_);
+                                pool_->put_magazine(spare_);
+                            }
+                            spare_.swap(loaded_);
+                        }
+                        loaded_.push_front(*::new (p) free_node);
+                    }
+
+                    // The pool of the cache.
+                    object_pool* pool_;
+                    // The magazine slots are taken from and returned to.
+                    magazine loaded_;
+                    // A second magazine, which is either empty or full.
+                    magazine spare_;
+            };
+
+        private:
+            // Returns the slab containing the slot p.
+            static slab* slab_of(const void* p) {
+                return reinterpret_cast<slab*>(reinterpret_cast<std::uintptr_t>(p) & ~std::uintptr_t(SlabSize - 1));
+            }
+
+            // Returns the memory of the slab s to the system.
+            static void free_slab(slab* s) {
+                s->~slab();
+                ::operator delete(static_cast<void*>(s), std::align_val_t(SlabSize));
+            }
+
+            // Moves the slots of the magazine m (if any) to the depot.
+            // The pool mutex must be held.
+            void put_magazine(magazine& m) {
+                if (!m.empty()) {
+                    depot_.push_back(std::move(m));
+                }
+            }
+
+            // Fills the empty magazine m from the depot, obtaining a new slab
+            // from the system if the depot is empty.
+            void get_magazine(magazine& m) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (depot_.empty()) {
+                    add_slab();
+                }
+                m.swap(depot_.back());
+                depot_.pop_back();
+            }
+
+            // Obtains a new slab from the system and adds its slots to the
+            // depot. The pool mutex must be held.
+            void add_slab() {
+                void* p = ::operator new(SlabSize, std::align_val_t(SlabSize));
+                slab* s = ::new (p) slab;
+                slabs_.push_back(*s);
+
+                // Chain the slots so that they are handed out in address order.
+                char* first = static_cast<char*>(p) + first_slot;
+                magazine m;
+                for (size_type i = objects_per_slab; i > 0; --i) {
+                    m.push_front(*::new (first + (i - 1) * slot_size) free_node);
+                    if (m.size() == magazine_size_) {
+                        depot_.push_back(std::move(m));
+                    }
+                }
+                if (!m.empty()) {
+                    depot_.push_back(std::move(m));
+                }
+            }
+
+            // The number of slots in a full magazine.
+            size_type magazine_size_;
+
+            // Guards the depot and the slabs.
+            std::mutex mutex_;
+
+            // The magazines of free slots not held by any cache.
+            std::vector<magazine> depot_;
+
+            // The slabs obtained from the system.
+            list<slab, base_hook<list_hook>> slabs_;
+    };
+}  // namespace ra::intrusive
+
+#endif
@@ -0,0 +1,509 @@
+#ifndef ra_intrusive_offset_list_hpp
+#define ra_intrusive_offset_list_hpp
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    template <class T, auto Hook>
+    class offset_list;
+    template <class P, auto Hook>
+    class offset_list_iterator;
+
+    // Per-node compressed list links.
+    // This type contains the successor and predecessor of a node in an
+    // offset_list, stored as 32-bit indices of the elements in the arena of
+    // the list rather than as pointers. The hook is therefore 8 bytes (half
+    // the size of a list_hook on 64-bit targets). This class has the
+    // offset_list class template as a friend.
+    class offset_list_hook {
+        public:
+            // Default construct an offset list hook.
+            // This constructor creates a hook that does not belong to any list.
+            offset_list_hook() : next_(0), prev_(0) {}
+
+            // Copy construct an offset list hook.
+            // This constructor creates a hook that does not belong to any list.
+            // The argument to the constructor is ignored.
+            offset_list_hook(const offset_list_hook&) : offset_list_hook() {}
+
+            // Copy assign an offset list hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            offset_list_hook& operator=(const offset_list_hook&) { return *this; }
+
+            // Destroy an offset list hook.
+            // The hook being destroyed must not belong to a list. If the hook
+            // belongs to a list, the resulting behavior is undefined.
+            ~offset_list_hook() = default;
+
+        private:
+            // The index of the next element in the list.
+            std::uint32_t next_;
+            // The index of the previous element in the list.
+            std::uint32_t prev_;
+
+            // Friend the offset_list class template.
+            template <class T, auto H>
+            friend class offset_list;
+
+            // Friend the offset_list_iterator class template.
+            template <class P, auto H>
+            friend class offset_list_iterator;
+    };
+
+    // Offset list iterator class.
+    // This class provides a bidirectional iterator for offset lists. The
+    // iterator holds the arena base and the sentinel of its list along with
+    // the index of the element it refers to.
+    template <class P, auto Hook>
+    class offset_list_iterator
+        : public boost::iterator_facade<offset_list_iterator<P, Hook>, P, boost::bidirectional_traversal_tag> {
+            using value_type_ = std::remove_const_t<P>;
+            using node = offset_list_hook;
+
+        public:
+            // Construct an offset list iterator.
+            offset_list_iterator() : base_(nullptr), sentinel_(nullptr), index_(0) {}
+
+            // Construct an offset list iterator referring to the element with
+            // the index index in the arena base (or to the sentinel if index is
+            // offset_list<T, Hook>::sentinel_index).
+            offset_list_iterator(value_type_* base, node* sentinel, std::uint32_t index)
+                : base_(base), sentinel_(sentinel), index_(index) {}
+
+            // Convert a mutating iterator to a non-mutating one.
+            template <class Other_ptr>
+            requires std::is_convertible_v<Other_ptr*, P*>
+            offset_list_iterator(const offset_list_iterator<Other_ptr, Hook>& other)
+                : base_(other.base_), sentinel_(other.sentinel_), index_(other.index_) {}
+
+            // Copy construct an offset list iterator.
+            offset_list_iterator(const offset_list_iterator& other) = default;
+
+            // Copy assign an offset list iterator.
+            offset_list_iterator& operator=(const offset_list_iterator& other) = default;
+
+            // Get the index of the element referred to by the iterator.
+            std::uint32_t get_index() const {
+                return index_;
+            }
+
+        private:
+            template <class Q, auto H>
+            friend class offset_list_iterator;
+
+            friend class boost::iterator_core_access;
+
+            // The conversions between hooks and elements.
+            using traits = hook_traits<value_type_, Hook>;
+
+            node* get_node() const {
+                return index_ == offset_list<value_type_, Hook>::sentinel_index ? sentinel_
+                                                                                 : traits::to_hook(base_ + index_);
+            }
+
+            P& dereference() const {
+                return base_[index_];
+            }
+
+            bool equal(const offset_list_iterator& other) const {
+                return index_ == other.index_ && sentinel_ == other.sentinel_;
+            }
+
+            void increment() {
+                index_ = get_node()->next_;
+            }
+
+            void decrement() {
+                index_ = get_node()->prev_;
+            }
+
+            // The arena of the list.
+            value_type_* base_;
+            // The sentinel of the list.
+            node* sentinel_;
+            // The index of the element referred to by the iterator.
+            std::uint32_t index_;
+    };
+
+    // Intrusive doubly-linked list of arena-resident elements.
+    //
+    // This list links elements that reside in a caller-supplied arena (an
+    // array of T starting at the base passed to the constructor), and stores
+    // the links in the offset_list_hook selected by Hook (see hook_traits) as
+    // 32-bit element indices relative to that base. An arena of up to
+    // 2^32 - 1 elements is supported, and twice as many hooks fit in a cache
+    // line as with list_hook. Since the elements never refer to the list
+    // object itself (the sentinel is represented by a reserved index), a
+    // list may be moved in constant time.
+    //
+    // All of the elements linked into a list (and all of the lists that
+    // exchange elements through splice) must share the same arena.
+    template <class T, auto Hook>
+    class offset_list {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using node = offset_list_hook;
+
+            static_assert(std::is_same_v<typename traits::hook_type, node>, "Hook must select an offset_list_hook");
+
+        public:
+            // The type of the elements in the list.
+            using value_type = T;
+
+            // The type of a mutating reference to an element in the list.
+            using reference = T&;
+
+            // The type of a non-mutating reference to an element in the list.
+            using const_reference = const T&;
+
+            // The mutating (bidirectional) iterator type for the list.
+            using iterator = offset_list_iterator<T, Hook>;
+
+            // The non-mutating (bidirectional) iterator type for the list.
+            using const_iterator = offset_list_iterator<const T, Hook>;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The index reserved for the sentinel of a list (so an arena holds
+            // at most sentinel_index elements).
+            static constexpr std::uint32_t sentinel_index = std::numeric_limits<std::uint32_t>::max();
+
+            // Construct a list.
+            //
+            // Creates an empty list of elements that reside in the arena
+            // starting at base.
+            //
+            // Time complexity:
+            // Constant.
+            explicit offset_list(T* base) : base_(base), size_(0) {
+                sentinel_.next_ = sentinel_index;
+                sentinel_.prev_ = sentinel_index;
+            }
+
+            // Destroy a list.
+            //
+            // Erases any elements from the list and then destroys the list.
+            //
+            // Time complexity:
+            // Constant.
+            ~offset_list() = default;
+
+            // Move construct a list.
+            //
+            // The elements of other are moved to the new list, preserving their
+            // relative order. After the move, other is empty.
+            //
+            // Time complexity:
+            // Constant.
+            offset_list(offset_list&& other) : base_(other.base_), sentinel_(), size_(other.size_) {
+                sentinel_.next_ = other.sentinel_.next_;
+                sentinel_.prev_ = other.sentinel_.prev_;
+                other.reset();
+            }
+
+            // Move assign a list.
+            //
+            // The elements of *this are erased, and the elements of other are
+            // then moved to *this, preserving their relative order. After the
+            // move, other is empty.
+            //
+            // Time complexity:
+            // Constant.
+            offset_list& operator=(offset_list&& other) {
+                if (this != &other) {
+                    base_ = other.base_;
+                    sentinel_.next_ = other.sentinel_.next_;
+                    sentinel_.prev_ = other.sentinel_.prev_;
+                    size_ = other.size_;
+                    other.reset();
+                }
+                return *this;
+            }
+
+            // Do not allow the copying of lists.
+            offset_list(const offset_list&) = delete;
+            offset_list& operator=(const offset_list&) = delete;
+
+            // Swap the elements of two lists.
+            //
+            // Time complexity:
+            // Constant.
+            void swap(offset_list& x) {
+                std::swap(base_, x.base_);
+                std::swap(sentinel_.next_, x.sentinel_.next_);
+                std::swap(sentinel_.prev_, x.sentinel_.prev_);
+                std::swap(size_, x.size_);
+            }
+
+            // Returns the base of the arena of the list.
+            //
+            // Time complexity:
+            // Constant.
+            T* base() const {
+                return base_;
+            }
+
+            // Returns the number of elements in the list.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the list contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return sentinel_.next_ == sentinel_index;
+            }
+
+            // Inserts the element x (which must reside in the arena of the list)
+            // before the element referred to by the iterator pos.
+            // An iterator that refers to the inserted element is returned.
+            //
+            // Time complexity:
+            // Constant.
+            iterator insert(const_iterator pos, reference x) {
+                std::uint32_t index = index_of(x);
+                std::uint32_t next = pos.get_index();
+                node* n = traits::to_hook(&x);
+                node* next_node = get_node(next);
+
+                n->next_ = next;
+                n->prev_ = next_node->prev_;
+                get_node(next_node->prev_)->next_ = index;
+                next_node->prev_ = index;
+                ++size_;
+
+                return make_iterator(index);
+            }
+
+            // Erases the element at the position specified by the iterator pos.
+            // An iterator that refers to the element following the erased element
+            // is returned if such an element exists; otherwise, end() is
+            // returned.
+            //
+            // Time complexity:
+            // Constant.
+            iterator erase(const_iterator pos) {
+                node* n = get_node(pos.get_index());
+                std::uint32_t next = n->next_;
+
+                get_node(n->prev_)->next_ = next;
+                get_node(next)->prev_ = n->prev_;
+                --size_;
+
+                return make_iterator(next);
+            }
+
+            // Inserts the element x at the beginning of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void push_front(reference x) {
+                insert(begin(), x);
+            }
+
+            // Inserts the element x at the end of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void push_back(reference x) {
+                insert(end(), x);
+            }
+
+            // Erases the first element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            void pop_front() {
+                erase(begin());
+            }
+
+            // Erases the last element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            void pop_back() {
+                erase(--end());
+            }
+
+            // Returns a reference to the first element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference front() {
+                return base_[sentinel_.next_];
+            }
+            const_reference front() const {
+                return base_[sentinel_.next_];
+            }
+
+            // Returns a reference to the last element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference back() {
+                return base_[sentinel_.prev_];
+            }
+            const_reference back() const {
+                return base_[sentinel_.prev_];
+            }
+
+            // Erases any elements from the list, yielding an empty list.
+            // Since erasure does not write to the erased hooks, the elements are
+            // simply forgotten.
+            //
+            // Time complexity:
+            // Constant.
+            void clear() {
+                reset();
+            }
+
+            // Moves all of the elements of the list other (which must share the
+            // arena of *this) into *this before the element referred to by the
+            // iterator pos. After the splice, other is empty.
+            //
+            // Precondition:
+            // The objects *this and other are distinct.
+            //
+            // Time complexity:
+            // Constant.
+            void splice(const_iterator pos, offset_list& other) {
+                if (other.empty()) {
+                    return;
+                }
+                assert(base_ == other.base_);
+
+                std::uint32_t first = other.sentinel_.next_;
+                std::uint32_t last = other.sentinel_.prev_;
+                node* next_node = get_node(pos.get_index());
+
+                get_node(next_node->prev_)->next_ = first;
+                get_node(first)->prev_ = next_node->prev_;
+                get_node(last)->next_ = pos.get_index();
+                next_node->prev_ = last;
+
+                size_ += other.size_;
+                other.reset();
+            }
+            void splice(const_iterator pos, offset_list&& other) {
+                splice(pos, other);
+            }
+
+            // Moves the element referred to by the iterator it from the list
+            // other (which must share the arena of *this) into *this before the
+            // element referred to by the iterator pos. The lists *this and other
+            // may be the same list.
+            //
+            // Time complexity:
+            // Constant.
+            void splice(const_iterator pos, offset_list& other, const_iterator it) {
+                std::uint32_t index = it.get_index();
+                node* n = get_node(index);
+
+                if (index != pos.get_index() && n->next_ != pos.get_index()) {
+                    assert(base_ == other.base_);
+                    other.erase(it);
+                    insert(pos, base_[index]);
+                }
+            }
+            void splice(const_iterator pos, offset_list&& other, const_iterator it) {
+                splice(pos, other, it);
+            }
+
+            // Returns an iterator referring to the first element in the list
+            // if the list is not empty and end() otherwise.
+            //
+            // Time complexity:
+            // Constant.
+            iterator begin() {
+                return make_iterator(sentinel_.next_);
+            }
+            const_iterator begin() const {
+                return const_cast<offset_list*>(this)->begin();
+            }
+
+            // Returns an iterator referring to the fictitious one-past-the-end
+            // element.
+            //
+            // Time complexity:
+            // Constant.
+            iterator end() {
+                return make_iterator(sentinel_index);
+            }
+            const_iterator end() const {
+                return const_cast<offset_list*>(this)->end();
+            }
+
+            // Returns an iterator referring to the element x, which must belong
+            // to the list.
+            //
+            // Time complexity:
+            // Constant.
+            iterator iterator_to(reference x) {
+                return make_iterator(index_of(x));
+            }
+            const_iterator iterator_to(const_reference x) const {
+                return const_cast<offset_list*>(this)->iterator_to(const_cast<reference>(x));
+            }
+
+        private:
+            // Returns the index of the element x in the arena.
+            std::uint32_t index_of(const_reference x) const {
+                std::ptrdiff_t index = &x - base_;
+                assert(index >= 0 && index < std::ptrdiff_t(sentinel_index));
+                return static_cast<std::uint32_t>(index);
+            }
+
+            // Returns the hook with the index index (or the sentinel).
+            node* get_node(std::uint32_t index) {
+                return index == sentinel_index ? &sentinel_ : traits::to_hook(base_ + index);
+            }
+
+            iterator make_iterator(std::uint32_t index) {
+                return iterator(base_, &sentinel_, index);
+            }
+
+            // Makes the list empty.
+            void reset() {
+                sentinel_.next_ = sentinel_index;
+                sentinel_.prev_ = sentinel_index;
+                size_ = 0;
+            }
+
+            // The base of the arena holding the elements.
+            T* base_;
+
+            // The sentinel, holding the indices of the first and last elements.
+            node sentinel_;
+
+            size_type size_;
+    };
+}  // namespace ra::intrusive
+
+#endif
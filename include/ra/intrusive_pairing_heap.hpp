@@ -0,0 +1,382 @@
+#ifndef ra_intrusive_pairing_heap_hpp
+#define ra_intrusive_pairing_heap_hpp
+
+#include <cstddef>
+#include <functional>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    template <class T, auto Hook, class Compare>
+    class pairing_heap;
+
+    // Per-node heap management information class.
+    // This type contains the per-node heap management information (i.e., the
+    // first child of the node, its next sibling, and either its previous
+    // sibling or, for a first child, its parent). The back pointer allows a
+    // node to be cut out of the heap in constant time. This class has the
+    // pairing_heap class template as a friend.
+    class pairing_heap_hook {
+        public:
+            // Default construct a heap hook.
+            // This constructor creates a heap hook that does not belong to any
+            // heap.
+            pairing_heap_hook() : child_(nullptr), sibling_(nullptr), prev_(nullptr) {}
+
+            // Copy construct a heap hook.
+            // This constructor creates a heap hook that does not belong to any
+            // heap. The argument to the constructor is ignored.
+            pairing_heap_hook(const pairing_heap_hook&) : pairing_heap_hook() {}
+
+            // Copy assign a heap hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            pairing_heap_hook& operator=(const pairing_heap_hook&) { return *this; }
+
+            // Destroy a heap hook.
+            // The heap hook being destroyed must not belong to a heap. If the
+            // heap hook belongs to a heap, the resulting behavior is undefined.
+            ~pairing_heap_hook() = default;
+
+        private:
+            // The first child of the node.
+            pairing_heap_hook* child_;
+            // The next sibling of the node.
+            pairing_heap_hook* sibling_;
+            // The previous sibling of the node, or its parent if the node is a
+            // first child (or null for the root).
+            pairing_heap_hook* prev_;
+
+            // Friend the pairing_heap class template.
+            template <class T, auto H, class C>
+            friend class pairing_heap;
+    };
+
+    // Intrusive pairing heap (mutable priority queue).
+    //
+    // The elements are linked through the pairing_heap_hook selected by Hook
+    // (see hook_traits), so no memory is allocated and elements are never
+    // copied or moved. As for std::priority_queue, the top of the heap is an
+    // element that no other element follows with respect to Compare (i.e.,
+    // the largest element with std::less). The priority of an element in
+    // the heap may only be changed through increase or update.
+    //
+    // With std::greater (a min-heap), increase is the classic decrease-key
+    // operation.
+    template <class T, auto Hook, class Compare = std::less<T>>
+    class pairing_heap {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using node = pairing_heap_hook;
+
+            static_assert(std::is_same_v<typename traits::hook_type, node>, "Hook must select a pairing_heap_hook");
+
+        public:
+            // The type of the elements in the heap.
+            using value_type = T;
+
+            // The type of the function/functor used to compare two elements.
+            using value_compare = Compare;
+
+            // The type of a mutating reference to an element in the heap.
+            using reference = T&;
+
+            // The type of a non-mutating reference to an element in the heap.
+            using const_reference = const T&;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a heap.
+            //
+            // Creates an empty heap with the specified comparison object.
+            //
+            // Time complexity:
+            // Constant.
+            explicit pairing_heap(const Compare& comp = Compare()) : root_(nullptr), size_(0), comp_(comp) {}
+
+            // Destroy a heap.
+            //
+            // Erases any elements from the heap (see clear) and then destroys the
+            // heap.
+            //
+            // Time complexity:
+            // Constant.
+            ~pairing_heap() = default;
+
+            // Move construct a heap.
+            //
+            // The elements of other are moved to the new heap. After the move,
+            // other is empty.
+            //
+            // Time complexity:
+            // Constant.
+            pairing_heap(pairing_heap&& other) : root_(other.root_), size_(other.size_), comp_(other.comp_) {
+                other.clear();
+            }
+
+            // Move assign a heap.
+            //
+            // The elements of *this are erased, and the elements of other are
+            // then moved to *this. After the move, other is empty.
+            //
+            // Time complexity:
+            // Constant.
+            pairing_heap& operator=(pairing_heap&& other) {
+                if (this != &other) {
+                    root_ = other.root_;
+                    size_ = other.size_;
+                    comp_ = other.comp_;
+                    other.clear();
+                }
+                return *this;
+            }
+
+            // Do not allow the copying of heaps.
+            pairing_heap(const pairing_heap&) = delete;
+            pairing_heap& operator=(const pairing_heap&) = delete;
+
+            // Swap the elements of two heaps.
+            //
+            // Time complexity:
+            // Constant.
+            void swap(pairing_heap& x) {
+                std::swap(root_, x.root_);
+                std::swap(size_, x.size_);
+                std::swap(comp_, x.comp_);
+            }
+
+            // Returns the number of elements in the heap.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the heap contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return root_ == nullptr;
+            }
+
+            // Get the comparison object for the heap.
+            //
+            // Time complexity:
+            // Constant.
+            value_compare value_comp() const {
+                return comp_;
+            }
+
+            // Returns a reference to the top element of the heap.
+            //
+            // Precondition:
+            // The heap is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference top() {
+                return *traits::to_value(root_);
+            }
+            const_reference top() const {
+                return *traits::to_value(root_);
+            }
+
+            // Inserts the element x in the heap.
+            //
+            // Time complexity:
+            // Constant.
+            void push(reference x) {
+                node* n = traits::to_hook(&x);
+                n->child_ = nullptr;
+                n->sibling_ = nullptr;
+                n->prev_ = nullptr;
+                root_ = root_ ? link(root_, n) : n;
+                ++size_;
+            }
+
+            // Erases the top element of the heap.
+            //
+            // Precondition:
+            // The heap is not empty.
+            //
+            // Time complexity:
+            // Amortized logarithmic.
+            void pop() {
+                node* old = root_;
+                root_ = merge_pairs(old->child_);
+                old->child_ = nullptr;
+                --size_;
+            }
+
+            // Erases the element x (which must belong to the heap).
+            //
+            // Time complexity:
+            // Amortized logarithmic.
+            void erase(reference x) {
+                node* n = traits::to_hook(&x);
+                if (n == root_) {
+                    pop();
+                    return;
+                }
+
+                cut(n);
+                node* children = merge_pairs(n->child_);
+                n->child_ = nullptr;
+                if (children) {
+                    root_ = link(root_, children);
+                }
+                --size_;
+            }
+
+            // Restores the heap order after the priority of the element x (which
+            // must belong to the heap) has been increased, i.e., after x has
+            // changed so that it follows no element that it did not follow
+            // before.
+            //
+            // Time complexity:
+            // Constant (amortized sublogarithmic).
+            void increase(reference x) {
+                node* n = traits::to_hook(&x);
+                if (n != root_) {
+                    cut(n);
+                    root_ = link(root_, n);
+                }
+            }
+
+            // Restores the heap order after the priority of the element x (which
+            // must belong to the heap) has changed in any way.
+            //
+            // Time complexity:
+            // Amortized logarithmic.
+            void update(reference x) {
+                erase(x);
+                push(x);
+            }
+
+            // Moves all of the elements of the heap other into *this. After the
+            // meld, other is empty.
+            //
+            // Precondition:
+            // The objects *this and other are distinct, and have equivalent
+            // comparison objects.
+            //
+            // Time complexity:
+            // Constant.
+            void meld(pairing_heap& other) {
+                if (other.root_) {
+                    root_ = root_ ? link(root_, other.root_) : other.root_;
+                    size_ += other.size_;
+                    other.clear();
+                }
+            }
+            void meld(pairing_heap&& other) {
+                meld(other);
+            }
+
+            // Erases any elements from the heap, yielding an empty heap.
+            // The hooks of the erased elements are not written, so the elements
+            // are simply forgotten (and may be pushed again).
+            //
+            // Time complexity:
+            // Constant.
+            void clear() {
+                root_ = nullptr;
+                size_ = 0;
+            }
+
+        private:
+            // Returns the element containing the hook n.
+            static const T& to_value(const node* n) {
+                return *traits::to_value(n);
+            }
+
+            // Links the roots a and b (which have no siblings) into one tree,
+            // and returns its root. On ties, a remains the root.
+            node* link(node* a, node* b) {
+                if (comp_(to_value(a), to_value(b))) {
+                    std::swap(a, b);
+                }
+
+                // Make b the first child of a.
+                b->sibling_ = a->child_;
+                if (b->sibling_) {
+                    b->sibling_->prev_ = b;
+                }
+                b->prev_ = a;
+                a->child_ = b;
+                return a;
+            }
+
+            // Detaches the non-root node n (with its subtree) from its parent and
+            // siblings.
+            static void cut(node* n) {
+                if (n->prev_->child_ == n) {
+                    n->prev_->child_ = n->sibling_;
+                } else {
+                    n->prev_->sibling_ = n->sibling_;
+                }
+                if (n->sibling_) {
+                    n->sibling_->prev_ = n->prev_;
+                }
+                n->sibling_ = nullptr;
+                n->prev_ = nullptr;
+            }
+
+            // Merges the sibling list starting at first into one tree (by the
+            // standard two-pass pairing), and returns its root (or null if the
+            // list is empty).
+            node* merge_pairs(node* first) {
+                if (!first) {
+                    return nullptr;
+                }
+
+                // Link the siblings in pairs from left to right, chaining the
+                // results (through sibling_) in reverse order.
+                node* pairs = nullptr;
+                while (first) {
+                    node* a = first;
+                    node* b = a->sibling_;
+                    a->prev_ = nullptr;
+                    a->sibling_ = nullptr;
+                    if (!b) {
+                        a->sibling_ = pairs;
+                        pairs = a;
+                        break;
+                    }
+
+                    first = b->sibling_;
+                    b->prev_ = nullptr;
+                    b->sibling_ = nullptr;
+                    node* m = link(a, b);
+                    m->sibling_ = pairs;
+                    pairs = m;
+                }
+
+                // Link the pairs from right to left.
+                node* root = pairs;
+                pairs = pairs->sibling_;
+                root->sibling_ = nullptr;
+                while (pairs) {
+                    node* next = pairs->sibling_;
+                    pairs->sibling_ = nullptr;
+                    root = link(pairs, root);
+                    pairs = next;
+                }
+                return root;
+            }
+
+            // The root of the heap (or null if the heap is empty).
+            node* root_;
+
+            size_type size_;
+
+            [[no_unique_address]] Compare comp_;
+    };
+}  // namespace ra::intrusive
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef ra_intrusive_prefetch_hpp
+#define ra_intrusive_prefetch_hpp
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace ra::intrusive {
+    namespace detail {
+        // Issues a read prefetch for the cache line containing p (where
+        // supported by the compiler).
+        inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, 0, 3);
+#else
+            (void)p;
+#endif
+        }
+    }  // namespace detail
+
+    // Prefetching iterator adaptor.
+    // This class adapts an iterator of an intrusive container (i.e., one
+    // providing get_node()) to a forward iterator that keeps a lookahead
+    // iterator distance elements ahead of the current element. Whenever the
+    // lookahead iterator advances, the hook of the element it reaches is
+    // prefetched (and, if payload is true, the first line of the element as
+    // well), so that the cache misses of a traversal overlap with the work
+    // done on the preceding elements.
+    //
+    // The lookahead iterator never passes the end of the traversal, so a
+    // prefetching iterator only compares its current position: an adaptor
+    // of end (with any distance) is a valid end iterator.
+    template <class Iterator>
+    class prefetch_iterator
+        : public boost::iterator_facade<prefetch_iterator<Iterator>,
+                                        std::remove_reference_t<typename std::iterator_traits<Iterator>::reference>,
+                                        boost::forward_traversal_tag> {
+        public:
+            // Construct a prefetching iterator.
+            prefetch_iterator() : payload_(false) {}
+
+            // Construct a prefetching iterator referring to the element at it
+            // in the traversal ending at end, which prefetches distance
+            // elements ahead.
+            prefetch_iterator(Iterator it, Iterator end, std::size_t distance, bool payload = false)
+                : it_(it), ahead_(it), end_(end), payload_(payload) {
+                for (std::size_t i = 0; i < distance && ahead_ != end_; ++i) {
+                    ++ahead_;
+                    prefetch_ahead();
+                }
+            }
+
+            // Get the underlying iterator.
+            Iterator base() const {
+                return it_;
+            }
+
+        private:
+            friend class boost::iterator_core_access;
+
+            typename std::iterator_traits<Iterator>::reference dereference() const {
+                return *it_;
+            }
+
+            bool equal(const prefetch_iterator& other) const {
+                return it_ == other.it_;
+            }
+
+            void increment() {
+                ++it_;
+                if (ahead_ != end_) {
+                    ++ahead_;
+                    prefetch_ahead();
+                }
+            }
+
+            // Prefetches the element referred to by the lookahead iterator.
+            void prefetch_ahead() const {
+                if (ahead_ != end_) {
+                    detail::prefetch(ahead_.get_node());
+                    if (payload_) {
+                        detail::prefetch(&*ahead_);
+                    }
+                }
+            }
+
+            // The current position.
+            Iterator it_;
+            // The position distance elements ahead (or end_).
+            Iterator ahead_;
+            // The end of the traversal.
+            Iterator end_;
+            // Whether the element (and not only its hook) is prefetched.
+            bool payload_;
+    };
+
+    // Returns a prefetching iterator referring to the first element of the
+    // container c, which prefetches distance elements ahead.
+    template <class Container>
+    auto prefetch_begin(Container& c, std::size_t distance, bool payload = false) {
+        return prefetch_iterator<decltype(c.begin())>(c.begin(), c.end(), distance, payload);
+    }
+
+    // Returns a prefetching iterator referring to the end of the container
+    // c.
+    template <class Container>
+    auto prefetch_end(Container& c) {
+        return prefetch_iterator<decltype(c.begin())>(c.end(), c.end(), 0);
+    }
+
+    // Calls f(x) for each element x of the container c in order, while
+    // prefetching the element distance positions ahead (see
+    // prefetch_iterator). The function object f is returned.
+    //
+    // Time complexity:
+    // Linear in the size of c.
+    template <class Container, class F>
+    F for_each_prefetch(Container& c, F f, std::size_t distance = 4, bool payload = false) {
+        for (auto it = prefetch_begin(c, distance, payload), end = prefetch_end(c); it != end; ++it) {
+            f(*it);
+        }
+        return f;
+    }
+}  // namespace ra::intrusive
+
+#endif
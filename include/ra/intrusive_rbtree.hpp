@@ -0,0 +1,716 @@
+#ifndef ra_intrusive_rbtree_hpp
+#define ra_intrusive_rbtree_hpp
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    template <class T, auto Hook, class Compare>
+    class rbtree;
+
+    namespace detail {
+        struct rbtree_algorithms;
+    }  // namespace detail
+
+    // Per-node tree management information class.
+    // This type contains the per-node tree management information (i.e., the
+    // parent and the left and right children of the node in the tree, and
+    // the color of the node). The color is stored in the low bit of the
+    // parent pointer (which is always zero since hooks are pointer aligned),
+    // so the hook is only three pointers in size. This class has the rbtree
+    // class template as a friend.
+    class set_hook {
+        public:
+            // Default construct a set hook.
+            // This constructor creates a set hook that does not belong to any
+            // tree.
+            set_hook() : parent_and_color_(0), left_(nullptr), right_(nullptr) {}
+
+            // Copy construct a set hook.
+            // This constructor creates a set hook that does not belong to any
+            // tree. The argument to the constructor is ignored.
+            set_hook(const set_hook&) : set_hook() {}
+
+            // Copy assign a set hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            set_hook& operator=(const set_hook&) { return *this; }
+
+            // Destroy a set hook.
+            // The set hook being destroyed must not belong to a tree. If the set
+            // hook belongs to a tree, the resulting behavior is undefined.
+            ~set_hook() = default;
+
+        private:
+            // The colors of a node.
+            enum color : std::uintptr_t { red = 0, black = 1 };
+
+            set_hook* parent() const {
+                return reinterpret_cast<set_hook*>(parent_and_color_ & ~std::uintptr_t(1));
+            }
+
+            void set_parent(set_hook* p) {
+                parent_and_color_ = reinterpret_cast<std::uintptr_t>(p) | (parent_and_color_ & 1);
+            }
+
+            color get_color() const {
+                return static_cast<color>(parent_and_color_ & 1);
+            }
+
+            void set_color(color c) {
+                parent_and_color_ = (parent_and_color_ & ~std::uintptr_t(1)) | c;
+            }
+
+            bool is_red() const {
+                return get_color() == red;
+            }
+
+            // The parent of the node (with the color of the node in the low
+            // bit).
+            std::uintptr_t parent_and_color_;
+            // The left child of the node.
+            set_hook* left_;
+            // The right child of the node.
+            set_hook* right_;
+
+            // Friend the rbtree class template and its algorithms.
+            template <class T, auto H, class C>
+            friend class rbtree;
+
+            friend struct detail::rbtree_algorithms;
+    };
+
+    static_assert(alignof(set_hook) >= 2, "the color bit requires aligned hooks");
+
+    namespace detail {
+        // Red-black tree algorithms on hooks.
+        // The tree has a header node whose parent is the root, whose left
+        // child is the leftmost (minimum) node, and whose right child is the
+        // rightmost (maximum) node. The header is red, and the root is black,
+        // which allows the header to be recognized when decrementing. These
+        // are the algorithms of the SGI STL.
+        struct rbtree_algorithms {
+            using node = set_hook;
+
+            static node* root(const node* header) {
+                return header->parent();
+            }
+
+            static node* minimum(node* x) {
+                while (x->left_) {
+                    x = x->left_;
+                }
+                return x;
+            }
+
+            static node* maximum(node* x) {
+                while (x->right_) {
+                    x = x->right_;
+                }
+                return x;
+            }
+
+            // Returns the in-order successor of x (the header if x is the
+            // maximum).
+            static node* next(node* x) {
+                if (x->right_) {
+                    return minimum(x->right_);
+                }
+                node* y = x->parent();
+                while (x == y->right_) {
+                    x = y;
+                    y = y->parent();
+                }
+                // The root is the right child of the header only if it is the
+                // maximum (so the successor is the header itself).
+                return x->right_ != y ? y : x;
+            }
+
+            // Returns the in-order predecessor of x (the maximum if x is the
+            // header).
+            static node* prev(node* x) {
+                if (x->is_red() && x->parent()->parent() == x) {
+                    return x->right_;
+                }
+                if (x->left_) {
+                    return maximum(x->left_);
+                }
+                node* y = x->parent();
+                while (x == y->left_) {
+                    x = y;
+                    y = y->parent();
+                }
+                return y;
+            }
+
+            // Replaces the child old_child of parent (or the root, if old_child
+            // is the root) with new_child.
+            static void replace_child(node* header, node* parent, node* old_child, node* new_child) {
+                if (old_child == root(header)) {
+                    header->set_parent(new_child);
+                } else if (old_child == parent->left_) {
+                    parent->left_ = new_child;
+                } else {
+                    parent->right_ = new_child;
+                }
+            }
+
+            static void rotate_left(node* header, node* x) {
+                node* y = x->right_;
+                x->right_ = y->left_;
+                if (y->left_) {
+                    y->left_->set_parent(x);
+                }
+                y->set_parent(x->parent());
+                replace_child(header, x->parent(), x, y);
+                y->left_ = x;
+                x->set_parent(y);
+            }
+
+            static void rotate_right(node* header, node* x) {
+                node* y = x->left_;
+                x->left_ = y->right_;
+                if (y->right_) {
+                    y->right_->set_parent(x);
+                }
+                y->set_parent(x->parent());
+                replace_child(header, x->parent(), x, y);
+                y->right_ = x;
+                x->set_parent(y);
+            }
+
+            // Links the node x as the left (if insert_left is true) or right
+            // child of p, and restores the red-black properties.
+            static void insert_and_rebalance(node* header, bool insert_left, node* x, node* p) {
+                x->parent_and_color_ = 0;
+                x->set_parent(p);
+                x->set_color(node::red);
+                x->left_ = nullptr;
+                x->right_ = nullptr;
+
+                if (insert_left) {
+                    // If p is the header, this also makes x the leftmost node.
+                    p->left_ = x;
+                    if (p == header) {
+                        header->set_parent(x);
+                        header->right_ = x;
+                    } else if (p == header->left_) {
+                        header->left_ = x;
+                    }
+                } else {
+                    p->right_ = x;
+                    if (p == header->right_) {
+                        header->right_ = x;
+                    }
+                }
+
+                while (x != root(header) && x->parent()->is_red()) {
+                    node* xp = x->parent();
+                    node* xpp = xp->parent();
+
+                    if (xp == xpp->left_) {
+                        node* y = xpp->right_;
+                        if (y && y->is_red()) {
+                            xp->set_color(node::black);
+                            y->set_color(node::black);
+                            xpp->set_color(node::red);
+                            x = xpp;
+                        } else {
+                            if (x == xp->right_) {
+                                x = xp;
+                                rotate_left(header, x);
+                            }
+                            x->parent()->set_color(node::black);
+                            xpp->set_color(node::red);
+                            rotate_right(header, xpp);
+                        }
+                    } else {
+                        node* y = xpp->left_;
+                        if (y && y->is_red()) {
+                            xp->set_color(node::black);
+                            y->set_color(node::black);
+                            xpp->set_color(node::red);
+                            x = xpp;
+                        } else {
+                            if (x == xp->left_) {
+                                x = xp;
+                                rotate_right(header, x);
+                            }
+                            x->parent()->set_color(node::black);
+                            xpp->set_color(node::red);
+                            rotate_left(header, xpp);
+                        }
+                    }
+                }
+                root(header)->set_color(node::black);
+            }
+
+            // Unlinks the node z from the tree and restores the red-black
+            // properties.
+            static void erase_and_rebalance(node* header, node* z) {
+                node* y = z;
+                node* x = nullptr;
+                node* x_parent = nullptr;
+
+                if (!y->left_) {
+                    x = y->right_;
+                } else if (!y->right_) {
+                    x = y->left_;
+                } else {
+                    // z has two children, so y is its successor (and x is the
+                    // only child of y, if any).
+                    y = minimum(y->right_);
+                    x = y->right_;
+                }
+
+                if (y != z) {
+                    // Relink y in place of z.
+                    z->left_->set_parent(y);
+                    y->left_ = z->left_;
+                    if (y != z->right_) {
+                        x_parent = y->parent();
+                        if (x) {
+                            x->set_parent(y->parent());
+                        }
+                        y->parent()->left_ = x;
+                        y->right_ = z->right_;
+                        z->right_->set_parent(y);
+                    } else {
+                        x_parent = y;
+                    }
+                    replace_child(header, z->parent(), z, y);
+                    y->set_parent(z->parent());
+
+                    node::color c = y->get_color();
+                    y->set_color(z->get_color());
+                    z->set_color(c);
+                    // z now has the color of the node removed from its position.
+                    y = z;
+                } else {
+                    x_parent = y->parent();
+                    if (x) {
+                        x->set_parent(y->parent());
+                    }
+                    replace_child(header, z->parent(), z, x);
+
+                    if (header->left_ == z) {
+                        header->left_ = z->right_ ? minimum(x) : z->parent();
+                    }
+                    if (header->right_ == z) {
+                        header->right_ = z->left_ ? maximum(x) : z->parent();
+                    }
+                }
+
+                if (!y->is_red()) {
+                    while (x != root(header) && (!x || !x->is_red())) {
+                        if (x == x_parent->left_) {
+                            node* w = x_parent->right_;
+                            if (w->is_red()) {
+                                w->set_color(node::black);
+                                x_parent->set_color(node::red);
+                                rotate_left(header, x_parent);
+                                w = x_parent->right_;
+                            }
+                            if ((!w->left_ || !w->left_->is_red()) && (!w->right_ || !w->right_->is_red())) {
+                                w->set_color(node::red);
+                                x = x_parent;
+                                x_parent = x_parent->parent();
+                            } else {
+                                if (!w->right_ || !w->right_->is_red()) {
+                                    w->left_->set_color(node::black);
+                                    w->set_color(node::red);
+                                    rotate_right(header, w);
+                                    w = x_parent->right_;
+                                }
+                                w->set_color(x_parent->get_color());
+                                x_parent->set_color(node::black);
+                                if (w->right_) {
+                                    w->right_->set_color(node::black);
+                                }
+                                rotate_left(header, x_parent);
+                                break;
+                            }
+                        } else {
+                            node* w = x_parent->left_;
+                            if (w->is_red()) {
+                                w->set_color(node::black);
+                                x_parent->set_color(node::red);
+                                rotate_right(header, x_parent);
+                                w = x_parent->left_;
+                            }
+                            if ((!w->right_ || !w->right_->is_red()) && (!w->left_ || !w->left_->is_red())) {
+                                w->set_color(node::red);
+                                x = x_parent;
+                                x_parent = x_parent->parent();
+                            } else {
+                                if (!w->left_ || !w->left_->is_red()) {
+                                    w->right_->set_color(node::black);
+                                    w->set_color(node::red);
+                                    rotate_left(header, w);
+                                    w = x_parent->left_;
+                                }
+                                w->set_color(x_parent->get_color());
+                                x_parent->set_color(node::black);
+                                if (w->left_) {
+                                    w->left_->set_color(node::black);
+                                }
+                                rotate_right(header, x_parent);
+                                break;
+                            }
+                        }
+                    }
+                    if (x) {
+                        x->set_color(node::black);
+                    }
+                }
+
+                z->parent_and_color_ = 0;
+                z->left_ = nullptr;
+                z->right_ = nullptr;
+            }
+        };
+    }  // namespace detail
+
+    // Tree iterator class.
+    // This class provides a bidirectional iterator that visits the elements
+    // of a tree in order. The iterator refers to a hook and uses the hook
+    // selector Hook to recover the element containing that hook.
+    template <class P, auto Hook>
+    class rbtree_iterator : public boost::iterator_facade<rbtree_iterator<P, Hook>, P, boost::bidirectional_traversal_tag> {
+        public:
+            // Construct a tree iterator.
+            explicit rbtree_iterator(set_hook* node = nullptr) : node_(node) {}
+
+            // Convert a mutating iterator to a non-mutating one.
+            template <class Other_ptr>
+            requires std::is_convertible_v<Other_ptr*, P*>
+            rbtree_iterator(const rbtree_iterator<Other_ptr, Hook>& other) : node_(other.node_) {}
+
+            // Copy construct a tree iterator.
+            rbtree_iterator(const rbtree_iterator& other) = default;
+
+            // Copy assign a tree iterator.
+            rbtree_iterator& operator=(const rbtree_iterator& other) = default;
+
+            // Get the hook referred to by the iterator.
+            set_hook* get_node() const {
+                return node_;
+            }
+
+        private:
+            template <class Q, auto H>
+            friend class rbtree_iterator;
+
+            friend class boost::iterator_core_access;
+
+            // The conversions between hooks and elements.
+            using traits = hook_traits<std::remove_const_t<P>, Hook>;
+
+            P& dereference() const {
+                return *traits::to_value(node_);
+            }
+
+            bool equal(const rbtree_iterator& other) const {
+                return node_ == other.node_;
+            }
+
+            void increment() {
+                node_ = detail::rbtree_algorithms::next(node_);
+            }
+
+            void decrement() {
+                node_ = detail::rbtree_algorithms::prev(node_);
+            }
+
+            // The node referred to by the iterator.
+            set_hook* node_;
+    };
+
+    // Intrusive red-black tree (of unique elements).
+    //
+    // The elements are linked through the set_hook selected by Hook (see
+    // hook_traits) and ordered by Compare, so no memory is allocated and
+    // elements are never copied or moved. The elements must not be modified
+    // in a way that changes their order while they are in the tree.
+    template <class T, auto Hook, class Compare = std::less<T>>
+    class rbtree {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using node = set_hook;
+            using algo = detail::rbtree_algorithms;
+
+            static_assert(std::is_same_v<typename traits::hook_type, node>, "Hook must select a set_hook");
+
+        public:
+            // The type of the elements in the tree.
+            using value_type = T;
+
+            // The type of the function/functor used to compare two elements.
+            using value_compare = Compare;
+
+            // The type of a mutating reference to an element in the tree.
+            using reference = T&;
+
+            // The type of a non-mutating reference to an element in the tree.
+            using const_reference = const T&;
+
+            // The mutating (bidirectional) iterator type for the tree.
+            using iterator = rbtree_iterator<T, Hook>;
+
+            // The non-mutating (bidirectional) iterator type for the tree.
+            using const_iterator = rbtree_iterator<const T, Hook>;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a tree.
+            //
+            // Creates an empty tree with the specified comparison object.
+            //
+            // Time complexity:
+            // Constant.
+            explicit rbtree(const Compare& comp = Compare()) : size_(0), comp_(comp) {
+                reset_header();
+            }
+
+            // Destroy a tree.
+            //
+            // Erases any elements from the tree and then destroys the tree.
+            //
+            // Time complexity:
+            // Linear in size().
+            ~rbtree() {
+                clear();
+            }
+
+            // Do not allow the copying of trees.
+            rbtree(const rbtree&) = delete;
+            rbtree& operator=(const rbtree&) = delete;
+
+            // Returns the number of elements in the tree.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the tree contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return size_ == 0;
+            }
+
+            // Get the comparison object for the tree.
+            //
+            // Time complexity:
+            // Constant.
+            value_compare value_comp() const {
+                return comp_;
+            }
+
+            // Inserts the element x in the tree.
+            // If an element equivalent to x is already in the tree, no insertion
+            // is performed.
+            //
+            // Return value:
+            // The second component of the returned pair is true if and only if
+            // the insertion takes place; and the first component refers to the
+            // element equivalent to x.
+            //
+            // Time complexity:
+            // Logarithmic.
+            std::pair<iterator, bool> insert_unique(reference x) {
+                node* y = &header_;
+                node* z = algo::root(&header_);
+                bool less = true;
+
+                while (z) {
+                    y = z;
+                    less = comp_(x, to_value(z));
+                    z = less ? z->left_ : z->right_;
+                }
+
+                // The candidate equivalent element is the predecessor of the
+                // insertion point.
+                node* j = y;
+                if (less) {
+                    if (j == header_.left_) {
+                        return std::make_pair(link(y, x, true), true);
+                    }
+                    j = algo::prev(j);
+                }
+                if (comp_(to_value(j), x)) {
+                    return std::make_pair(link(y, x, less), true);
+                }
+                return std::make_pair(iterator(j), false);
+            }
+
+            // Erases the element at the position specified by the iterator pos.
+            // An iterator that refers to the element following the erased
+            // element is returned if such an element exists; otherwise, end()
+            // is returned.
+            //
+            // Time complexity:
+            // Logarithmic.
+            iterator erase(const_iterator pos) {
+                node* z = pos.get_node();
+                iterator next(algo::next(z));
+                algo::erase_and_rebalance(&header_, z);
+                --size_;
+                return next;
+            }
+
+            // Erases the element x (which must belong to the tree).
+            //
+            // Time complexity:
+            // Logarithmic.
+            void erase(reference x) {
+                erase(iterator_to(x));
+            }
+
+            // Returns an iterator referring to the first element that is not
+            // less than k, or end() if there is no such element. The function
+            // object comp(x, k) must return true if the element x is less than
+            // the key k (and must be consistent with the order of the tree).
+            //
+            // Time complexity:
+            // Logarithmic.
+            template <class Key, class ValueKeyCompare>
+            iterator lower_bound(const Key& k, ValueKeyCompare comp) {
+                node* y = &header_;
+                for (node* x = algo::root(&header_); x;) {
+                    if (!comp(to_value(x), k)) {
+                        y = x;
+                        x = x->left_;
+                    } else {
+                        x = x->right_;
+                    }
+                }
+                return iterator(y);
+            }
+            template <class Key, class ValueKeyCompare>
+            const_iterator lower_bound(const Key& k, ValueKeyCompare comp) const {
+                return const_cast<rbtree*>(this)->lower_bound(k, comp);
+            }
+            iterator lower_bound(const_reference x) {
+                return lower_bound(x, comp_);
+            }
+            const_iterator lower_bound(const_reference x) const {
+                return lower_bound(x, comp_);
+            }
+
+            // Returns an iterator referring to the element equivalent to x, or
+            // end() if there is no such element.
+            //
+            // Time complexity:
+            // Logarithmic.
+            iterator find(const_reference x) {
+                iterator it = lower_bound(x);
+                return it != end() && !comp_(x, *it) ? it : end();
+            }
+            const_iterator find(const_reference x) const {
+                return const_cast<rbtree*>(this)->find(x);
+            }
+
+            // Returns an iterator referring to the element x, which must belong
+            // to the tree.
+            //
+            // Time complexity:
+            // Constant.
+            iterator iterator_to(reference x) {
+                return iterator(traits::to_hook(&x));
+            }
+            const_iterator iterator_to(const_reference x) const {
+                return const_iterator(const_cast<node*>(traits::to_hook(&x)));
+            }
+
+            // Erases any elements from the tree, yielding an empty tree.
+            //
+            // Time complexity:
+            // Linear in size().
+            void clear() {
+                // Unlink the nodes bottom-up without rebalancing.
+                node* x = algo::root(&header_);
+                while (x) {
+                    if (x->left_) {
+                        x = x->left_;
+                    } else if (x->right_) {
+                        x = x->right_;
+                    } else {
+                        node* p = x->parent();
+                        x->parent_and_color_ = 0;
+                        if (p == &header_) {
+                            break;
+                        }
+                        (p->left_ == x ? p->left_ : p->right_) = nullptr;
+                        x = p;
+                    }
+                }
+                reset_header();
+                size_ = 0;
+            }
+
+            // Returns an iterator referring to the first (smallest) element in
+            // the tree if the tree is not empty and end() otherwise.
+            //
+            // Time complexity:
+            // Constant.
+            iterator begin() {
+                return iterator(header_.left_);
+            }
+            const_iterator begin() const {
+                return const_iterator(header_.left_);
+            }
+
+            // Returns an iterator referring to the fictitious one-past-the-end
+            // element.
+            //
+            // Time complexity:
+            // Constant.
+            iterator end() {
+                return iterator(&header_);
+            }
+            const_iterator end() const {
+                return const_iterator(const_cast<node*>(&header_));
+            }
+
+        private:
+            static T& to_value(node* n) {
+                return *traits::to_value(n);
+            }
+
+            // Makes the header represent an empty tree.
+            void reset_header() {
+                header_.parent_and_color_ = 0;
+                header_.set_color(node::red);
+                header_.left_ = &header_;
+                header_.right_ = &header_;
+            }
+
+            // Links the element x as a child of the node p.
+            iterator link(node* p, reference x, bool insert_left) {
+                node* z = traits::to_hook(&x);
+                algo::insert_and_rebalance(&header_, insert_left || p == &header_, z, p);
+                ++size_;
+                return iterator(z);
+            }
+
+            // The header node (see detail::rbtree_algorithms).
+            node header_;
+
+            size_type size_;
+
+            [[no_unique_address]] Compare comp_;
+    };
+}  // namespace ra::intrusive
+
+#endif
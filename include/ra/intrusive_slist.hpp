@@ -0,0 +1,418 @@
+#ifndef ra_intrusive_slist_hpp
+#define ra_intrusive_slist_hpp
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    class slist_hook;
+    template <class T, auto Hook, bool CacheLast>
+    class slist;
+
+    // Per-node singly-linked list management information class.
+    // This type contains the per-node list management information (i.e.,
+    // only the successor in the list), so it is half the size of a
+    // list_hook. This class has the slist class template as a friend.
+    class slist_hook {
+        public:
+            // Default construct a list hook.
+            // This constructor creates a list hook that does not belong to any
+            // list.
+            slist_hook() : next_(nullptr) {}
+
+            // Copy construct a list hook.
+            // This constructor creates a list hook that does not belong to any
+            // list. The argument to the constructor is ignored.
+            slist_hook(const slist_hook&) : next_(nullptr) {}
+
+            // Copy assign a list hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            slist_hook& operator=(const slist_hook&) { return *this; }
+
+            // Destroy a list hook.
+            // The list hook being destroyed must not belong to a list. If the
+            // list hook belongs to a list, the resulting behavior is undefined.
+            ~slist_hook() {
+                next_ = nullptr;
+            }
+
+        private:
+            // The next node in the list (or null for the last node).
+            slist_hook* next_;
+
+            // Friend the slist class template.
+            template <class T, auto H, bool C>
+            friend class slist;
+
+            // Friend the slist_iterator class template.
+            template <class P, auto H>
+            friend class slist_iterator;
+    };
+
+    // Singly-linked list iterator class.
+    // This class provides a forward iterator for singly-linked lists. The
+    // iterator refers to a hook and uses the hook selector Hook to recover
+    // the element containing that hook (see hook_traits).
+    template <class P, auto Hook>
+    class slist_iterator : public boost::iterator_facade<slist_iterator<P, Hook>, P, boost::forward_traversal_tag> {
+        public:
+            // Construct a list iterator.
+            explicit slist_iterator(slist_hook* node = nullptr) : node_(node) {}
+
+            // Convert a mutating iterator to a non-mutating one.
+            template <class Other_ptr>
+            requires std::is_convertible_v<Other_ptr*, P*>
+            slist_iterator(const slist_iterator<Other_ptr, Hook>& other) : node_(other.node_) {}
+
+            // Copy construct a list iterator.
+            slist_iterator(const slist_iterator& other) = default;
+
+            // Copy assign a list iterator.
+            slist_iterator& operator=(const slist_iterator& other) = default;
+
+            // Get the hook referred to by the iterator.
+            slist_hook* get_node() const {
+                return node_;
+            }
+
+        private:
+            template <class Q, auto H>
+            friend class slist_iterator;
+
+            friend class boost::iterator_core_access;
+
+            // The conversions between hooks and elements.
+            using traits = hook_traits<std::remove_const_t<P>, Hook>;
+
+            P& dereference() const {
+                return *traits::to_value(node_);
+            }
+
+            bool equal(const slist_iterator& other) const {
+                return node_ == other.node_;
+            }
+
+            void increment() {
+                node_ = node_->next_;
+            }
+
+            // The node referred to by the list iterator.
+            slist_hook* node_;
+    };
+
+    // Intrusive singly-linked list (with header node).
+    // The Hook parameter selects the slist_hook object that links the
+    // elements: either a pointer-to-member of T (e.g., &T::hook), or
+    // base_hook<slist_hook> if T derives from slist_hook.
+    //
+    // If CacheLast is true, the list keeps a pointer to its last node so
+    // that push_back and back are constant time. If CacheLast is false, the
+    // list object is one pointer smaller and push_back/back are unavailable.
+    template <class T, auto Hook, bool CacheLast = true>
+    class slist {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            static_assert(std::is_same_v<typename traits::hook_type, slist_hook>, "Hook must select an slist_hook");
+
+        public:
+            // The type of the elements in the list.
+            using value_type = T;
+
+            // The hook selector associated with the list hook object.
+            static constexpr auto hook_ptr = Hook;
+
+            // Whether the list caches a pointer to its last node.
+            static constexpr bool cache_last = CacheLast;
+
+            // The type of a mutating reference to a node in the list.
+            using reference = T&;
+
+            // The type of a non-mutating reference to a node in the list.
+            using const_reference = const T&;
+
+            // The mutating (forward) iterator type for the list.
+            using iterator = slist_iterator<T, Hook>;
+
+            // The non-mutating (forward) iterator type for the list.
+            using const_iterator = slist_iterator<const T, Hook>;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a list.
+            //
+            // Creates an empty list.
+            //
+            // Time complexity:
+            // Constant.
+            slist() : size_(0) {
+                if constexpr (CacheLast) {
+                    last_ = &head_;
+                }
+            }
+
+            // Destroy a list.
+            //
+            // Erases any elements from the list and then destroys the list.
+            //
+            // Time complexity:
+            // Linear.
+            ~slist() {
+                clear();
+            }
+
+            // Move construct a list.
+            //
+            // The elements in the source list (i.e., other) are moved from the
+            // source list to the destination list (i.e., *this), preserving their
+            // relative order. After the move, the source list is empty.
+            //
+            // Time complexity:
+            // Constant.
+            slist(slist&& other) : slist() {
+                swap(other);
+            }
+
+            // Move assign a list.
+            //
+            // Any elements in the destination list are erased, and the elements
+            // of the source list (i.e., other) are then moved to the destination
+            // list. After the move, the source list is empty.
+            //
+            // Time complexity:
+            // Linear in size().
+            slist& operator=(slist&& other) {
+                if (this != &other) {
+                    clear();
+                    swap(other);
+                }
+                return *this;
+            }
+
+            // Do not allow the copying of lists.
+            slist(const slist&) = delete;
+            slist& operator=(const slist&) = delete;
+
+            // Swap the elements of two lists.
+            //
+            // Swapping the elements of a list with itself has no effect.
+            //
+            // Time complexity:
+            // Constant.
+            void swap(slist& x) {
+                if (this != &x) {
+                    std::swap(head_.next_, x.head_.next_);
+                    std::swap(size_, x.size_);
+                    if constexpr (CacheLast) {
+                        std::swap(last_, x.last_);
+                        // An empty list caches its own header node.
+                        if (last_ == &x.head_) {
+                            last_ = &head_;
+                        }
+                        if (x.last_ == &head_) {
+                            x.last_ = &x.head_;
+                        }
+                    }
+                }
+            }
+
+            // Returns the number of elements in the list.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the list contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return head_.next_ == nullptr;
+            }
+
+            // Inserts an element in the list after the element referred to by
+            // the iterator pos (which may be before_begin()).
+            // An iterator that refers to the inserted element is returned.
+            //
+            // Time complexity:
+            // Constant.
+            iterator insert_after(const_iterator pos, value_type& value) {
+                slist_hook* prev = pos.get_node();
+                slist_hook* node = traits::to_hook(&value);
+
+                node->next_ = prev->next_;
+                prev->next_ = node;
+                if constexpr (CacheLast) {
+                    if (prev == last_) {
+                        last_ = node;
+                    }
+                }
+                ++size_;
+
+                return iterator(node);
+            }
+
+            // Erases the element following the element referred to by the
+            // iterator pos (which may be before_begin()).
+            // An iterator that refers to the element following the erased element
+            // is returned if such an element exists; otherwise, end() is
+            // returned.
+            //
+            // Precondition:
+            // The element following pos exists.
+            //
+            // Time complexity:
+            // Constant.
+            iterator erase_after(const_iterator pos) {
+                slist_hook* prev = pos.get_node();
+                slist_hook* node = prev->next_;
+
+                prev->next_ = node->next_;
+                node->next_ = nullptr;
+                if constexpr (CacheLast) {
+                    if (node == last_) {
+                        last_ = prev;
+                    }
+                }
+                --size_;
+
+                return iterator(prev->next_);
+            }
+
+            // Inserts the element x at the beginning of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void push_front(value_type& x) {
+                insert_after(before_begin(), x);
+            }
+
+            // Inserts the element x at the end of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void push_back(value_type& x)
+            requires CacheLast
+            {
+                slist_hook* node = traits::to_hook(&x);
+
+                node->next_ = nullptr;
+                last_->next_ = node;
+                last_ = node;
+                ++size_;
+            }
+
+            // Erases the first element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            void pop_front() {
+                erase_after(before_begin());
+            }
+
+            // Returns a reference to the first element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference front() {
+                return *begin();
+            }
+            const_reference front() const {
+                return *begin();
+            }
+
+            // Returns a reference to the last element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference back()
+            requires CacheLast
+            {
+                return *iterator(last_);
+            }
+            const_reference back() const
+            requires CacheLast
+            {
+                return *const_iterator(last_);
+            }
+
+            // Erases any elements from the list, yielding an empty list.
+            //
+            // Time complexity:
+            // Linear.
+            void clear() {
+                while (!empty()) {
+                    pop_front();
+                }
+            }
+
+            // Returns an iterator referring to the fictitious element before
+            // the first element in the list. This iterator may only be used
+            // as the position argument of insert_after and erase_after, or be
+            // incremented.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator before_begin() const {
+                return const_iterator(const_cast<slist_hook*>(&head_));
+            }
+            iterator before_begin() {
+                return iterator(&head_);
+            }
+
+            // Returns an iterator referring to the first element in the list
+            // if the list is not empty and end() otherwise.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator begin() const {
+                return const_iterator(head_.next_);
+            }
+            iterator begin() {
+                return iterator(head_.next_);
+            }
+
+            // Returns an iterator referring to the fictitious one-past-the-end
+            // element.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator end() const {
+                return const_iterator();
+            }
+            iterator end() {
+                return iterator();
+            }
+
+        private:
+            // The placeholder for last_ when the last node is not cached.
+            struct no_last {};
+
+            // The header node (whose successor is the first node).
+            slist_hook head_;
+
+            // The last node in the list (or the header node if the list is
+            // empty). Only maintained if CacheLast is true.
+            [[no_unique_address]] std::conditional_t<CacheLast, slist_hook*, no_last> last_;
+
+            size_type size_;
+    };
+}  // namespace ra::intrusive
+
+#endif
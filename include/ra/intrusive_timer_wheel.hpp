@@ -0,0 +1,233 @@
+#ifndef ra_intrusive_timer_wheel_hpp
+#define ra_intrusive_timer_wheel_hpp
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ra/intrusive_hook_traits.hpp>
+#include <ra/intrusive_list.hpp>
+#include <type_traits>
+
+namespace ra::intrusive {
+    // Hierarchical timer wheel.
+    //
+    // The timers are elements of type T. The Hook parameter selects the
+    // auto-unlink list hook (basic_list_hook<link_mode::auto_unlink>) that
+    // links a timer into a wheel slot, and the Expiry parameter is a
+    // pointer to a data member of T (of type time_type) in which the wheel
+    // records the expiry time of the timer. Since the hook is auto-unlink, a
+    // timer is cancelled by simply unlinking it (or destroying it).
+    //
+    // Time is measured in ticks. The wheel has Levels levels of 2^SlotBits
+    // slots, each holding a list of timers, where the slots of level i each
+    // span 2^(SlotBits * i) ticks. A timer is placed at the lowest level
+    // whose range covers its remaining time. Whenever the lowest level wraps
+    // around, the next slot of the level above is spliced out and its timers
+    // are placed again (now at a lower level), and so on up the levels.
+    // Timers further in the future than the range of the wheel are parked in
+    // the top level and placed again until they come within range.
+    //
+    // Arming, cancelling and ticking are constant time (the cascading of a
+    // timer is amortized over the ticks that pass before it expires), and no
+    // memory is allocated after construction.
+    template <class T, auto Hook, auto Expiry, int SlotBits = 8, int Levels = 4>
+    class timer_wheel {
+        public:
+            // The type used to represent times (in ticks).
+            using time_type = std::uint64_t;
+
+            // The type of the timers.
+            using value_type = T;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The number of bits of a time that select a slot at each level.
+            static constexpr int slot_bits = SlotBits;
+
+            // The number of slots at each level.
+            static constexpr size_type slots = size_type(1) << slot_bits;
+
+            // The number of levels.
+            static constexpr int levels = Levels;
+
+        private:
+            // The lists of timers in the slots.
+            using list_type = list<T, Hook>;
+
+            static_assert(list_type::mode == link_mode::auto_unlink, "Hook must select an auto-unlink list hook");
+            static_assert(std::is_same_v<decltype(Expiry), time_type T::*>, "Expiry must select a time_type member of T");
+            static_assert(SlotBits > 0 && Levels > 0 && SlotBits * Levels < 64, "The wheel must cover fewer than 2^64 ticks");
+
+            // The number of ticks covered by the slots of the wheel.
+            static constexpr time_type range = time_type(1) << (slot_bits * levels);
+
+            static constexpr time_type slot_mask = slots - 1;
+
+        public:
+            // Construct a timer wheel.
+            //
+            // Creates a wheel without any timers, whose current time is now.
+            //
+            // Time complexity:
+            // Constant.
+            explicit timer_wheel(time_type now = 0) : now_(now) {}
+
+            // Destroy a timer wheel.
+            //
+            // Cancels any timers in the wheel.
+            //
+            // Time complexity:
+            // Linear in the number of timers.
+            ~timer_wheel() = default;
+
+            // Do not allow the copying of timer wheels.
+            timer_wheel(const timer_wheel&) = delete;
+            timer_wheel& operator=(const timer_wheel&) = delete;
+
+            // Returns the current time.
+            //
+            // Time complexity:
+            // Constant.
+            time_type now() const {
+                return now_;
+            }
+
+            // Arms the timer x to expire at the time expiry, cancelling it
+            // first if it is armed. A timer whose expiry time is not after the
+            // current time expires at the next tick.
+            //
+            // Time complexity:
+            // Constant.
+            void arm(T& x, time_type expiry) {
+                cancel(x);
+                x.*Expiry = expiry > now_ ? expiry : now_ + 1;
+                place(x);
+            }
+
+            // Arms the timer x to expire delay ticks after the current time.
+            //
+            // Time complexity:
+            // Constant.
+            void arm_after(T& x, time_type delay) {
+                arm(x, now_ + delay);
+            }
+
+            // Cancels the timer x. This has no effect if x is not armed.
+            //
+            // Time complexity:
+            // Constant.
+            static void cancel(T& x) {
+                hook_traits<T, Hook>::to_hook(&x)->unlink();
+            }
+
+            // Returns true if the timer x is armed.
+            //
+            // Time complexity:
+            // Constant.
+            static bool armed(const T& x) {
+                return hook_traits<T, Hook>::to_hook(&x)->is_linked();
+            }
+
+            // Advances the current time by one tick, and calls f(x) for each
+            // timer x that expires at the new time. Each timer is cancelled
+            // before it is passed to f, so f may arm it again (or destroy it).
+            // The number of expired timers is returned.
+            //
+            // Time complexity:
+            // Constant plus linear in the number of expired timers (and,
+            // amortized, the number of timers cascaded).
+            template <class F>
+            size_type tick(F f) {
+                ++now_;
+
+                // Cascade each level whose lower levels have wrapped around.
+                for (int level = 1; level < levels; ++level) {
+                    if ((now_ & low_mask(level)) != 0) {
+                        break;
+                    }
+                    cascade(slot(level, now_));
+                }
+
+                // Splice out the current slot, so that timers armed by f for
+                // the next tick are not visited now.
+                list_type expired;
+                expired.splice(expired.end(), slot(0, now_));
+
+                size_type count = 0;
+                while (!expired.empty()) {
+                    T& x = *expired.begin();
+                    cancel(x);
+                    ++count;
+                    f(x);
+                }
+                return count;
+            }
+
+            // Advances the current time to the time t (which must not be
+            // before the current time) one tick at a time, calling f as for
+            // tick. The number of expired timers is returned.
+            //
+            // Time complexity:
+            // Linear in t - now() plus the number of expired timers.
+            template <class F>
+            size_type advance_to(time_type t, F f) {
+                size_type count = 0;
+                while (now_ < t) {
+                    count += tick(f);
+                }
+                return count;
+            }
+
+        private:
+            // Returns the mask of the time bits below the slot bits of level.
+            static constexpr time_type low_mask(int level) {
+                return (time_type(1) << (slot_bits * level)) - 1;
+            }
+
+            // Returns the slot of level that covers the time t.
+            list_type& slot(int level, time_type t) {
+                return wheel_[level][(t >> (slot_bits * level)) & slot_mask];
+            }
+
+            // Links the (unlinked) timer x into the slot for its expiry time,
+            // which must not be before the current time. A timer expiring at
+            // the current time (when cascaded) goes to the current slot of the
+            // lowest level, which is about to expire.
+            void place(T& x) {
+                time_type expiry = x.*Expiry;
+                time_type delta = expiry - now_;
+                if (delta >= range) {
+                    // Park the timer in the last slot of the top level to be
+                    // cascaded, from which it is placed again.
+                    expiry = now_ + range - 1;
+                    delta = range - 1;
+                }
+
+                int level = 0;
+                while (delta >> (slot_bits * (level + 1)) != 0) {
+                    ++level;
+                }
+                slot(level, expiry).push_back(x);
+            }
+
+            // Places again each timer in the slot s.
+            void cascade(list_type& s) {
+                list_type timers;
+                timers.splice(timers.end(), s);
+                while (!timers.empty()) {
+                    T& x = *timers.begin();
+                    cancel(x);
+                    place(x);
+                }
+            }
+
+            // The current time.
+            time_type now_;
+
+            // The slots of each level.
+            std::array<std::array<list_type, slots>, levels> wheel_;
+    };
+}  // namespace ra::intrusive
+
+#endif
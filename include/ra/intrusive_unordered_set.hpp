@@ -0,0 +1,650 @@
+#ifndef ra_intrusive_unordered_set_hpp
+#define ra_intrusive_unordered_set_hpp
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    template <class T, auto Hook, class Hash, class KeyEqual>
+    class unordered_set;
+
+    // Per-node hash table management information class.
+    // This type contains the per-node hash table management information
+    // (i.e., the next node in the same bucket) and, if StoreHash is true, the
+    // hash of the element. Storing the hash makes lookups skip most key
+    // comparisons and makes rehashing avoid calling the hash function, at
+    // the cost of one word per element. This class has the unordered_set
+    // class template as a friend.
+    template <bool StoreHash>
+    class basic_unordered_set_hook {
+        public:
+            // The type of the hash table links (used by unordered_set for hook
+            // types derived from this one).
+            using unordered_set_node_type = basic_unordered_set_hook;
+
+            // Whether the hook stores the hash of the element.
+            static constexpr bool store_hash = StoreHash;
+
+            // Default construct a hook.
+            // This constructor creates a hook that does not belong to any set.
+            basic_unordered_set_hook() : next_(nullptr), hash_() {}
+
+            // Copy construct a hook.
+            // This constructor creates a hook that does not belong to any set.
+            // The argument to the constructor is ignored.
+            basic_unordered_set_hook(const basic_unordered_set_hook&) : basic_unordered_set_hook() {}
+
+            // Copy assign a hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            basic_unordered_set_hook& operator=(const basic_unordered_set_hook&) { return *this; }
+
+            // Destroy a hook.
+            // The hook being destroyed must not belong to a set. If the hook
+            // belongs to a set, the resulting behavior is undefined.
+            ~basic_unordered_set_hook() = default;
+
+        private:
+            // The placeholder for hash_ when the hash is not stored.
+            struct no_hash {};
+
+            // The next node in the same bucket.
+            basic_unordered_set_hook* next_;
+
+            // The hash of the element (only stored if StoreHash is true).
+            [[no_unique_address]] std::conditional_t<StoreHash, std::size_t, no_hash> hash_;
+
+            // Friend the unordered_set class template.
+            template <class T, auto H, class Hs, class E>
+            friend class unordered_set;
+
+            // Friend the unordered_set_iterator class template.
+            template <class S, class P>
+            friend class unordered_set_iterator;
+    };
+
+    // The default unordered set hook (which does not store the hash).
+    using unordered_set_hook = basic_unordered_set_hook<false>;
+
+    // A bucket of an unordered_set.
+    // This is a standard-layout type whose zero-initialized value is an
+    // empty bucket, so that bucket arrays can be provided by the user (e.g.,
+    // allocated in an arena).
+    template <class Node>
+    struct unordered_set_bucket {
+        // The first node in the bucket.
+        Node* head = nullptr;
+    };
+
+    // Unordered set iterator class.
+    // This class provides a forward iterator over the elements of an
+    // unordered_set S, visiting the elements bucket by bucket.
+    template <class S, class P>
+    class unordered_set_iterator : public boost::iterator_facade<unordered_set_iterator<S, P>, P,
+                                                                 boost::forward_traversal_tag> {
+            using node = typename S::node_type;
+
+        public:
+            // Construct an end iterator.
+            unordered_set_iterator() : set_(nullptr), node_(nullptr), table_(0), bucket_(0) {}
+
+            // Convert a mutating iterator to a non-mutating one.
+            template <class Other_ptr>
+            requires std::is_convertible_v<Other_ptr*, P*>
+            unordered_set_iterator(const unordered_set_iterator<S, Other_ptr>& other)
+                : set_(other.set_), node_(other.node_), table_(other.table_), bucket_(other.bucket_) {}
+
+            // Copy construct an iterator.
+            unordered_set_iterator(const unordered_set_iterator& other) = default;
+
+            // Copy assign an iterator.
+            unordered_set_iterator& operator=(const unordered_set_iterator& other) = default;
+
+        private:
+            template <class, class>
+            friend class unordered_set_iterator;
+
+            template <class T, auto H, class Hs, class E>
+            friend class unordered_set;
+
+            friend class boost::iterator_core_access;
+
+            // Construct an iterator referring to the node n, which is in the
+            // given bucket of the given table of the set s.
+            unordered_set_iterator(const S* s, node* n, int table, std::size_t bucket)
+                : set_(s), node_(n), table_(table), bucket_(bucket) {}
+
+            P& dereference() const {
+                return *S::to_value(node_);
+            }
+
+            bool equal(const unordered_set_iterator& other) const {
+                return node_ == other.node_;
+            }
+
+            void increment() {
+                node_ = node_->next_;
+                if (!node_) {
+                    set_->next_node(node_, table_, bucket_);
+                }
+            }
+
+            // The set being iterated over.
+            const S* set_;
+            // The node referred to by the iterator (or null at the end).
+            node* node_;
+            // The table containing the node (see unordered_set::table_at).
+            int table_;
+            // The index of the bucket containing the node.
+            std::size_t bucket_;
+    };
+
+    // Intrusive hash set with incremental rehashing.
+    //
+    // The elements are linked into singly-linked buckets through the
+    // unordered set hook selected by Hook (see hook_traits), so no memory
+    // is allocated per element. The number of buckets is always a power of
+    // two.
+    //
+    // Bucket storage:
+    // The set either allocates its bucket array itself (and grows it
+    // automatically, keeping the load factor at most one), or uses a bucket
+    // array provided by the user (which it never replaces on its own; see
+    // rehash).
+    //
+    // Iterator invalidation:
+    // Inserting or erasing an element invalidates iterators (but not
+    // references) while a rehash is in progress, and an insert that starts
+    // a rehash invalidates all iterators.
+    //
+    // Incremental rehashing:
+    // A rehash does not move all of the elements at once. Instead, the old
+    // and new bucket arrays are kept side by side, and each subsequent
+    // insert or erase moves the elements of a few old buckets to the new
+    // array. A lookup searches the array that currently holds the bucket of
+    // the key. Therefore, no single operation stalls to rehash the whole
+    // table.
+    template <class T, auto Hook, class Hash = std::hash<T>, class KeyEqual = std::equal_to<T>>
+    class unordered_set {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            using hook_type = typename traits::hook_type;
+
+        public:
+            // The type of the hash table links in the hook.
+            using node_type = typename hook_type::unordered_set_node_type;
+
+        private:
+            using node = node_type;
+
+            static_assert(std::is_base_of_v<node, hook_type>, "Hook must select an unordered set hook");
+
+        public:
+            // The type of the elements in the set.
+            using value_type = T;
+
+            // The type of a mutating reference to an element in the set.
+            using reference = T&;
+
+            // The type of a non-mutating reference to an element in the set.
+            using const_reference = const T&;
+
+            // The mutating (forward) iterator type for the set.
+            using iterator = unordered_set_iterator<unordered_set, T>;
+
+            // The non-mutating (forward) iterator type for the set.
+            using const_iterator = unordered_set_iterator<unordered_set, const T>;
+
+            // The type of a bucket.
+            using bucket_type = unordered_set_bucket<node>;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The number of old buckets migrated by each insert or erase while
+            // a rehash is in progress. Since a growing set doubles its bucket
+            // count, this guarantees that a rehash completes before the set
+            // needs to grow again.
+            static constexpr size_type rehash_step = 2;
+
+            // Construct a set that allocates its own buckets.
+            //
+            // Creates an empty set with (at least) bucket_count buckets. The
+            // bucket array grows automatically.
+            //
+            // Time complexity:
+            // Linear in bucket_count.
+            explicit unordered_set(size_type bucket_count = 16, const Hash& hash = Hash(),
+                                   const KeyEqual& equal = KeyEqual())
+                : size_(0), migrated_(0), grows_(true), hash_(hash), equal_(equal) {
+                size_type count = 1;
+                while (count < bucket_count) {
+                    count *= 2;
+                }
+                owned_ = std::make_unique<bucket_type[]>(count);
+                table_ = {owned_.get(), count};
+            }
+
+            // Construct a set that uses the buckets provided by the user.
+            //
+            // Creates an empty set whose buckets are the bucket_count buckets
+            // starting at buckets. The buckets must be empty (e.g., value
+            // initialized), bucket_count must be a power of two, and the
+            // bucket array must outlive its use by the set. The set never
+            // grows the bucket array automatically.
+            //
+            // Time complexity:
+            // Constant.
+            unordered_set(bucket_type* buckets, size_type bucket_count, const Hash& hash = Hash(),
+                          const KeyEqual& equal = KeyEqual())
+                : table_{buckets, bucket_count}, size_(0), migrated_(0), grows_(false), hash_(hash), equal_(equal) {
+                assert(is_power_of_two(bucket_count));
+            }
+
+            // Destroy a set.
+            //
+            // Erases any elements from the set and then destroys the set.
+            //
+            // Time complexity:
+            // Linear in size() and bucket_count().
+            ~unordered_set() {
+                clear();
+            }
+
+            // Do not allow the copying of sets.
+            unordered_set(const unordered_set&) = delete;
+            unordered_set& operator=(const unordered_set&) = delete;
+
+            // Returns the number of elements in the set.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the set contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return size_ == 0;
+            }
+
+            // Returns the number of buckets (in the new bucket array if a rehash
+            // is in progress).
+            //
+            // Time complexity:
+            // Constant.
+            size_type bucket_count() const {
+                return table_.count;
+            }
+
+            // Returns the average number of elements per bucket.
+            //
+            // Time complexity:
+            // Constant.
+            float load_factor() const {
+                return static_cast<float>(size_) / static_cast<float>(table_.count);
+            }
+
+            // Returns true if a rehash is in progress (i.e., the old bucket
+            // array is still in use).
+            //
+            // Time complexity:
+            // Constant.
+            bool rehashing() const {
+                return old_.buckets != nullptr;
+            }
+
+            // Inserts the element x in the set.
+            // If an element equal to x is already in the set, no insertion is
+            // performed.
+            //
+            // Return value:
+            // The second component of the returned pair is true if and only if
+            // the insertion takes place; and the first component refers to the
+            // element equal to x.
+            //
+            // Time complexity:
+            // Constant on average.
+            std::pair<iterator, bool> insert(reference x) {
+                step();
+
+                std::size_t h = hash_(x);
+                if (iterator it = find(x, h, hash_, equal_); it != end()) {
+                    return std::make_pair(it, false);
+                }
+
+                node* n = traits::to_hook(&x);
+                set_hash(n, h);
+
+                auto [table, index] = locate(h);
+                bucket_type& bucket = table_at(table).buckets[index];
+                n->next_ = bucket.head;
+                bucket.head = n;
+                ++size_;
+
+                if (grows_ && !rehashing() && size_ > table_.count) {
+                    rehash(table_.count * 2);
+                }
+
+                return std::make_pair(iterator(this, n, table, index), true);
+            }
+
+            // Finds the element equal to x.
+            // An iterator referring to the element is returned, or end() if
+            // there is no such element.
+            //
+            // Time complexity:
+            // Constant on average.
+            iterator find(const_reference x) {
+                return find(x, hash_(x), hash_, equal_);
+            }
+            const_iterator find(const_reference x) const {
+                return const_cast<unordered_set*>(this)->find(x);
+            }
+
+            // Finds the element with the key k, where key_hash(k) must be equal
+            // to the hash of an element equivalent to k, and key_equal(k, x)
+            // determines whether k is equivalent to the element x.
+            // An iterator referring to the element is returned, or end() if
+            // there is no such element.
+            //
+            // Time complexity:
+            // Constant on average.
+            template <class Key, class KeyHash, class KeyValueEqual>
+            iterator find(const Key& k, KeyHash key_hash, KeyValueEqual key_equal) {
+                return find(k, key_hash(k), key_hash, key_equal);
+            }
+            template <class Key, class KeyHash, class KeyValueEqual>
+            const_iterator find(const Key& k, KeyHash key_hash, KeyValueEqual key_equal) const {
+                return const_cast<unordered_set*>(this)->find(k, key_hash, key_equal);
+            }
+
+            // Returns the number of elements equal to x (i.e., zero or one).
+            //
+            // Time complexity:
+            // Constant on average.
+            size_type count(const_reference x) const {
+                return find(x) != end() ? 1 : 0;
+            }
+
+            // Erases the element x (which must belong to the set).
+            //
+            // Time complexity:
+            // Constant on average.
+            void erase(reference x) {
+                step();
+
+                node* n = traits::to_hook(&x);
+                auto [table, index] = locate(get_hash(n));
+
+                node** link = &table_at(table).buckets[index].head;
+                while (*link != n) {
+                    link = &(*link)->next_;
+                }
+                *link = n->next_;
+                n->next_ = nullptr;
+                --size_;
+            }
+
+            // Starts rehashing the set into a bucket array allocated by the set
+            // with (at least) bucket_count buckets. The rehash is then carried
+            // out incrementally by subsequent inserts and erases (or at once by
+            // complete_rehash). If a rehash is already in progress, it is
+            // completed first.
+            //
+            // Time complexity:
+            // Linear in bucket_count (plus the remainder of any rehash in
+            // progress).
+            void rehash(size_type bucket_count) {
+                size_type count = 1;
+                while (count < bucket_count) {
+                    count *= 2;
+                }
+
+                complete_rehash();
+                std::unique_ptr<bucket_type[]> buckets = std::make_unique<bucket_type[]>(count);
+                start_rehash(buckets.get(), count);
+                old_owned_ = std::move(owned_);
+                owned_ = std::move(buckets);
+            }
+
+            // Starts rehashing the set into the bucket_count buckets starting at
+            // buckets, which are provided by the user (with the same
+            // requirements as for the constructor). The old bucket array is no
+            // longer used by the set once rehashing() returns false. If a rehash
+            // is already in progress, it is completed first.
+            //
+            // Time complexity:
+            // Constant (plus the remainder of any rehash in progress).
+            void rehash(bucket_type* buckets, size_type bucket_count) {
+                assert(is_power_of_two(bucket_count));
+
+                complete_rehash();
+                start_rehash(buckets, bucket_count);
+                old_owned_ = std::move(owned_);
+            }
+
+            // Completes the rehash in progress, if any.
+            //
+            // Time complexity:
+            // Linear in the number of old buckets not yet migrated and the
+            // elements in them.
+            void complete_rehash() {
+                while (rehashing()) {
+                    migrate();
+                }
+            }
+
+            // Erases any elements from the set, yielding an empty set.
+            //
+            // Time complexity:
+            // Linear in size() and bucket_count().
+            void clear() {
+                complete_rehash();
+                for (size_type i = 0; i < table_.count; ++i) {
+                    for (node* n = table_.buckets[i].head; n;) {
+                        node* next = n->next_;
+                        n->next_ = nullptr;
+                        n = next;
+                    }
+                    table_.buckets[i].head = nullptr;
+                }
+                size_ = 0;
+            }
+
+            // Returns an iterator referring to the first element in the set if
+            // the set is not empty and end() otherwise.
+            //
+            // Time complexity:
+            // Linear in bucket_count() in the worst case.
+            iterator begin() {
+                iterator it(this, nullptr, new_table, 0);
+                if (rehashing()) {
+                    it.table_ = old_table;
+                    it.bucket_ = migrated_;
+                }
+                it.node_ = bucket_head(it.table_, it.bucket_);
+                if (!it.node_) {
+                    next_node(it.node_, it.table_, it.bucket_);
+                }
+                return it.node_ ? it : end();
+            }
+            const_iterator begin() const {
+                return const_cast<unordered_set*>(this)->begin();
+            }
+
+            // Returns an iterator referring to the fictitious one-past-the-end
+            // element.
+            //
+            // Time complexity:
+            // Constant.
+            iterator end() {
+                return iterator();
+            }
+            const_iterator end() const {
+                return const_iterator();
+            }
+
+        private:
+            template <class, class>
+            friend class unordered_set_iterator;
+
+            // A bucket array.
+            struct table {
+                bucket_type* buckets;
+                size_type count;
+            };
+
+            // The identifiers of the tables.
+            static constexpr int new_table = 0;
+            static constexpr int old_table = 1;
+
+            static bool is_power_of_two(size_type n) {
+                return n != 0 && (n & (n - 1)) == 0;
+            }
+
+            // Returns the element containing the node.
+            static T* to_value(node* n) {
+                return traits::to_value(static_cast<hook_type*>(n));
+            }
+
+            // Returns the hash of the element containing the node.
+            std::size_t get_hash(node* n) const {
+                if constexpr (node::store_hash) {
+                    return n->hash_;
+                } else {
+                    return hash_(*to_value(n));
+                }
+            }
+
+            // Records the hash of the element containing the node.
+            static void set_hash([[maybe_unused]] node* n, [[maybe_unused]] std::size_t h) {
+                if constexpr (node::store_hash) {
+                    n->hash_ = h;
+                }
+            }
+
+            table& table_at(int t) {
+                return t == new_table ? table_ : old_;
+            }
+            const table& table_at(int t) const {
+                return t == new_table ? table_ : old_;
+            }
+
+            node* bucket_head(int t, size_type index) const {
+                return table_at(t).buckets[index].head;
+            }
+
+            // Returns the table and bucket that hold the elements with hash h.
+            std::pair<int, size_type> locate(std::size_t h) const {
+                if (rehashing()) {
+                    size_type index = h & (old_.count - 1);
+                    if (index >= migrated_) {
+                        return std::make_pair(old_table, index);
+                    }
+                }
+                return std::make_pair(new_table, h & (table_.count - 1));
+            }
+
+            // Finds the element equivalent to k, whose hash is h.
+            template <class Key, class KeyHash, class KeyValueEqual>
+            iterator find(const Key& k, std::size_t h, KeyHash&, KeyValueEqual& key_equal) {
+                auto [table, index] = locate(h);
+                for (node* n = bucket_head(table, index); n; n = n->next_) {
+                    if constexpr (node::store_hash) {
+                        if (n->hash_ != h) {
+                            continue;
+                        }
+                    }
+                    if (key_equal(k, *to_value(n))) {
+                        return iterator(this, n, table, index);
+                    }
+                }
+                return end();
+            }
+
+            // Advances an iteration position (whose node is null) to the first
+            // node of the next non-empty bucket. The node remains null if there
+            // is no such bucket. The old table (if any) is visited before the
+            // new table.
+            void next_node(node*& n, int& t, size_type& bucket) const {
+                for (;;) {
+                    if (++bucket >= table_at(t).count) {
+                        if (t == new_table) {
+                            return;
+                        }
+                        t = new_table;
+                        bucket = 0;
+                    }
+                    if ((n = bucket_head(t, bucket))) {
+                        return;
+                    }
+                }
+            }
+
+            // Makes the bucket array the new table, and the current table the
+            // old table whose buckets are to be migrated.
+            void start_rehash(bucket_type* buckets, size_type count) {
+                old_ = table_;
+                table_ = {buckets, count};
+                migrated_ = 0;
+            }
+
+            // Performs a step of the rehash in progress, if any.
+            void step() {
+                for (size_type i = 0; i < rehash_step && rehashing(); ++i) {
+                    migrate();
+                }
+            }
+
+            // Moves the elements of the next old bucket to the new table.
+            void migrate() {
+                for (node* n = old_.buckets[migrated_].head; n;) {
+                    node* next = n->next_;
+                    bucket_type& bucket = table_.buckets[get_hash(n) & (table_.count - 1)];
+                    n->next_ = bucket.head;
+                    bucket.head = n;
+                    n = next;
+                }
+                old_.buckets[migrated_].head = nullptr;
+
+                if (++migrated_ == old_.count) {
+                    old_ = {nullptr, 0};
+                    old_owned_.reset();
+                }
+            }
+
+            // The (new) bucket array.
+            table table_;
+
+            // The old bucket array while a rehash is in progress.
+            table old_ = {nullptr, 0};
+
+            // The bucket arrays allocated by the set (if any).
+            std::unique_ptr<bucket_type[]> owned_;
+            std::unique_ptr<bucket_type[]> old_owned_;
+
+            size_type size_;
+
+            // The number of old buckets migrated so far.
+            size_type migrated_;
+
+            // Whether the set grows its bucket array automatically.
+            bool grows_;
+
+            [[no_unique_address]] Hash hash_;
+            [[no_unique_address]] KeyEqual equal_;
+    };
+}  // namespace ra::intrusive
+
+#endif
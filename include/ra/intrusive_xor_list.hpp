@@ -0,0 +1,483 @@
+#ifndef ra_intrusive_xor_list_hpp
+#define ra_intrusive_xor_list_hpp
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace ra::intrusive {
+    class xor_list_hook;
+    template <class T, auto Hook>
+    class xor_list;
+    template <class P, auto Hook>
+    class xor_list_iterator;
+
+    // Per-node XOR-linked list management information class.
+    // This type contains the exclusive or of the addresses of the
+    // predecessor and successor of a node (where a missing neighbor is
+    // null), so it is a single word (half the size of a list_hook). Either
+    // neighbor can be recovered from the other one. This class has the
+    // xor_list class template as a friend.
+    class xor_list_hook {
+        public:
+            // Default construct a list hook.
+            // This constructor creates a list hook that does not belong to any
+            // list.
+            xor_list_hook() : link_(0) {}
+
+            // Copy construct a list hook.
+            // This constructor creates a list hook that does not belong to any
+            // list. The argument to the constructor is ignored.
+            xor_list_hook(const xor_list_hook&) : link_(0) {}
+
+            // Copy assign a list hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            xor_list_hook& operator=(const xor_list_hook&) { return *this; }
+
+            // Destroy a list hook.
+            // The list hook being destroyed must not belong to a list. If the
+            // list hook belongs to a list, the resulting behavior is undefined.
+            ~xor_list_hook() = default;
+
+        private:
+            // Returns the address of a node as an integer.
+            static std::uintptr_t bits(const xor_list_hook* node) {
+                return reinterpret_cast<std::uintptr_t>(node);
+            }
+
+            // Returns the neighbor of this node that is not neighbor.
+            xor_list_hook* other(const xor_list_hook* neighbor) const {
+                return reinterpret_cast<xor_list_hook*>(link_ ^ bits(neighbor));
+            }
+
+            // Replaces the neighbor from with the neighbor to.
+            void relink(const xor_list_hook* from, const xor_list_hook* to) {
+                link_ ^= bits(from) ^ bits(to);
+            }
+
+            // The exclusive or of the addresses of the previous and next nodes.
+            std::uintptr_t link_;
+
+            // Friend the xor_list class template.
+            template <class T, auto H>
+            friend class xor_list;
+
+            // Friend the xor_list_iterator class template.
+            template <class P, auto H>
+            friend class xor_list_iterator;
+    };
+
+    // XOR-linked list iterator class.
+    // This class provides a bidirectional iterator for XOR-linked lists.
+    // Since a hook only yields a neighbor given the other neighbor, the
+    // iterator holds both the node it refers to and the node preceding it.
+    // The end iterator refers to the null node following the last element.
+    template <class P, auto Hook>
+    class xor_list_iterator
+        : public boost::iterator_facade<xor_list_iterator<P, Hook>, P, boost::bidirectional_traversal_tag> {
+        public:
+            // Construct a list iterator referring to node, whose predecessor is
+            // prev.
+            explicit xor_list_iterator(xor_list_hook* prev = nullptr, xor_list_hook* node = nullptr)
+                : prev_(prev), node_(node) {}
+
+            // Convert a mutating iterator to a non-mutating one.
+            template <class Other_ptr>
+            requires std::is_convertible_v<Other_ptr*, P*>
+            xor_list_iterator(const xor_list_iterator<Other_ptr, Hook>& other)
+                : prev_(other.prev_), node_(other.node_) {}
+
+            // Copy construct a list iterator.
+            xor_list_iterator(const xor_list_iterator& other) = default;
+
+            // Copy assign a list iterator.
+            xor_list_iterator& operator=(const xor_list_iterator& other) = default;
+
+            // Get the hook referred to by the iterator (null for end()).
+            xor_list_hook* get_node() const {
+                return node_;
+            }
+
+            // Get the hook preceding the one referred to by the iterator (null
+            // for begin()).
+            xor_list_hook* get_prev() const {
+                return prev_;
+            }
+
+        private:
+            template <class Q, auto H>
+            friend class xor_list_iterator;
+
+            friend class boost::iterator_core_access;
+
+            // The conversions between hooks and elements.
+            using traits = hook_traits<std::remove_const_t<P>, Hook>;
+
+            P& dereference() const {
+                return *traits::to_value(node_);
+            }
+
+            // Two iterators into the same list are equal if they refer to the
+            // same node, so an end() obtained before a push_back still compares
+            // equal to an incremented iterator.
+            bool equal(const xor_list_iterator& other) const {
+                return node_ == other.node_;
+            }
+
+            void increment() {
+                xor_list_hook* next = node_->other(prev_);
+                prev_ = node_;
+                node_ = next;
+            }
+
+            void decrement() {
+                xor_list_hook* prev = prev_->other(node_);
+                node_ = prev_;
+                prev_ = prev;
+            }
+
+            // The node preceding the one referred to by the iterator.
+            xor_list_hook* prev_;
+            // The node referred to by the iterator.
+            xor_list_hook* node_;
+    };
+
+    // Intrusive XOR-linked doubly-linked list.
+    // The Hook parameter selects the xor_list_hook object that links the
+    // elements: either a pointer-to-member of T (e.g., &T::hook), or
+    // base_hook<xor_list_hook> if T derives from xor_list_hook.
+    //
+    // The list supports traversal in both directions from either end,
+    // insertion and removal at both ends, and splicing of whole lists, with
+    // a one-word hook. An element cannot be located in the list from its
+    // hook alone, so there is no iterator_to, and insert and erase take an
+    // iterator (which carries the predecessor of its node). Inserting or
+    // erasing an element invalidates the iterators referring to its
+    // neighbors (in addition to the erased element), since they cache its
+    // address.
+    template <class T, auto Hook>
+    class xor_list {
+            // The conversions between hooks and elements.
+            using traits = hook_traits<T, Hook>;
+
+            static_assert(std::is_same_v<typename traits::hook_type, xor_list_hook>,
+                          "Hook must select an xor_list_hook");
+
+        public:
+            // The type of the elements in the list.
+            using value_type = T;
+
+            // The hook selector associated with the list hook object.
+            static constexpr auto hook_ptr = Hook;
+
+            // The type of a mutating reference to a node in the list.
+            using reference = T&;
+
+            // The type of a non-mutating reference to a node in the list.
+            using const_reference = const T&;
+
+            // The mutating (bidirectional) iterator type for the list.
+            using iterator = xor_list_iterator<T, Hook>;
+
+            // The non-mutating (bidirectional) iterator type for the list.
+            using const_iterator = xor_list_iterator<const T, Hook>;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Default construct a list.
+            //
+            // Creates an empty list.
+            //
+            // Time complexity:
+            // Constant.
+            xor_list() : first_(nullptr), last_(nullptr), size_(0) {}
+
+            // Destroy a list.
+            //
+            // Erases any elements from the list and then destroys the list.
+            //
+            // Time complexity:
+            // Linear.
+            ~xor_list() {
+                clear();
+            }
+
+            // Move construct a list.
+            //
+            // The elements in the source list (i.e., other) are moved from the
+            // source list to the destination list (i.e., *this), preserving their
+            // relative order. After the move, the source list is empty.
+            //
+            // Time complexity:
+            // Constant.
+            xor_list(xor_list&& other) : xor_list() {
+                swap(other);
+            }
+
+            // Move assign a list.
+            //
+            // Any elements in the destination list are erased, and the elements
+            // of the source list (i.e., other) are then moved to the destination
+            // list. After the move, the source list is empty.
+            //
+            // Time complexity:
+            // Linear in size().
+            xor_list& operator=(xor_list&& other) {
+                if (this != &other) {
+                    clear();
+                    swap(other);
+                }
+                return *this;
+            }
+
+            // Do not allow the copying of lists.
+            xor_list(const xor_list&) = delete;
+            xor_list& operator=(const xor_list&) = delete;
+
+            // Swap the elements of two lists.
+            //
+            // Time complexity:
+            // Constant.
+            void swap(xor_list& x) {
+                std::swap(first_, x.first_);
+                std::swap(last_, x.last_);
+                std::swap(size_, x.size_);
+            }
+
+            // Returns the number of elements in the list.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_;
+            }
+
+            // Returns true if the list contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return first_ == nullptr;
+            }
+
+            // Inserts an element in the list before the element referred to by
+            // the iterator pos.
+            // An iterator that refers to the inserted element is returned.
+            //
+            // Time complexity:
+            // Constant.
+            iterator insert(const_iterator pos, value_type& value) {
+                xor_list_hook* prev = pos.get_prev();
+                xor_list_hook* next = pos.get_node();
+                xor_list_hook* node = traits::to_hook(&value);
+
+                node->link_ = xor_list_hook::bits(prev) ^ xor_list_hook::bits(next);
+                if (prev) {
+                    prev->relink(next, node);
+                } else {
+                    first_ = node;
+                }
+                if (next) {
+                    next->relink(prev, node);
+                } else {
+                    last_ = node;
+                }
+                ++size_;
+
+                return iterator(prev, node);
+            }
+
+            // Erases the element at the position specified by the iterator pos.
+            // An iterator that refers to the element following the erased element
+            // is returned if such an element exists; otherwise, end() is
+            // returned.
+            //
+            // Time complexity:
+            // Constant.
+            iterator erase(const_iterator pos) {
+                xor_list_hook* prev = pos.get_prev();
+                xor_list_hook* node = pos.get_node();
+                xor_list_hook* next = node->other(prev);
+
+                if (prev) {
+                    prev->relink(node, next);
+                } else {
+                    first_ = next;
+                }
+                if (next) {
+                    next->relink(node, prev);
+                } else {
+                    last_ = prev;
+                }
+                node->link_ = 0;
+                --size_;
+
+                return iterator(prev, next);
+            }
+
+            // Inserts the element x at the beginning of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void push_front(value_type& x) {
+                insert(begin(), x);
+            }
+
+            // Inserts the element x at the end of the list.
+            //
+            // Time complexity:
+            // Constant.
+            void push_back(value_type& x) {
+                insert(end(), x);
+            }
+
+            // Erases the first element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            void pop_front() {
+                erase(begin());
+            }
+
+            // Erases the last element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            void pop_back() {
+                erase(--end());
+            }
+
+            // Returns a reference to the first element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference front() {
+                return *traits::to_value(first_);
+            }
+            const_reference front() const {
+                return *traits::to_value(first_);
+            }
+
+            // Returns a reference to the last element in the list.
+            //
+            // Precondition:
+            // The list is not empty.
+            //
+            // Time complexity:
+            // Constant.
+            reference back() {
+                return *traits::to_value(last_);
+            }
+            const_reference back() const {
+                return *traits::to_value(last_);
+            }
+
+            // Erases any elements from the list, yielding an empty list.
+            //
+            // Time complexity:
+            // Linear.
+            void clear() {
+                while (!empty()) {
+                    pop_front();
+                }
+            }
+
+            // Moves all of the elements of the list other into *this before the
+            // element referred to by the iterator pos, preserving their relative
+            // order. After the splice, other is empty.
+            //
+            // Precondition:
+            // The objects *this and other are distinct.
+            //
+            // Time complexity:
+            // Constant.
+            void splice(const_iterator pos, xor_list& other) {
+                if (other.empty()) {
+                    return;
+                }
+
+                xor_list_hook* prev = pos.get_prev();
+                xor_list_hook* next = pos.get_node();
+
+                other.first_->relink(nullptr, prev);
+                other.last_->relink(nullptr, next);
+                if (prev) {
+                    prev->relink(next, other.first_);
+                } else {
+                    first_ = other.first_;
+                }
+                if (next) {
+                    next->relink(prev, other.last_);
+                } else {
+                    last_ = other.last_;
+                }
+                size_ += other.size_;
+
+                other.first_ = nullptr;
+                other.last_ = nullptr;
+                other.size_ = 0;
+            }
+            void splice(const_iterator pos, xor_list&& other) {
+                splice(pos, other);
+            }
+
+            // Reverses the order of the elements in the list.
+            // Since a hook does not distinguish its predecessor from its
+            // successor, only the ends of the list are exchanged.
+            //
+            // Time complexity:
+            // Constant.
+            void reverse() {
+                std::swap(first_, last_);
+            }
+
+            // Returns an iterator referring to the first element in the list
+            // if the list is not empty and end() otherwise.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator begin() const {
+                return const_iterator(nullptr, first_);
+            }
+            iterator begin() {
+                return iterator(nullptr, first_);
+            }
+
+            // Returns an iterator referring to the fictitious one-past-the-end
+            // element.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator end() const {
+                return const_iterator(last_, nullptr);
+            }
+            iterator end() {
+                return iterator(last_, nullptr);
+            }
+
+        private:
+            // The first node in the list (or null if the list is empty).
+            xor_list_hook* first_;
+
+            // The last node in the list (or null if the list is empty).
+            xor_list_hook* last_;
+
+            size_type size_;
+    };
+}  // namespace ra::intrusive
+
+#endif
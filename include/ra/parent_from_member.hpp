@@ -16,6 +16,48 @@ object from a pointer to one of its members.
 
 namespace ra::util {
 
+// Extract the parent and member types of a pointer-to-member type.
+template <class>
+struct member_pointer_traits;
+
+template <class Parent, class Member>
+struct member_pointer_traits<Member Parent::*> {
+	using parent_type = Parent;
+	using member_type = Member;
+};
+
+namespace detail {
+
+// Storage in which a Parent object can be named without being
+// constructed.
+template <class Parent>
+union offset_probe {
+	constexpr offset_probe() : bytes{} {}
+	constexpr ~offset_probe() {}
+	char bytes[sizeof(Parent)];
+	Parent object;
+};
+
+}
+
+// Determine the offset of a member within its parent at compile time.
+// The member is located by comparing its address with the address of
+// each byte of a (never constructed) parent object, so no null pointer
+// is dereferenced and no code is generated.
+template <class Parent, class Member>
+consteval std::ptrdiff_t constexpr_offset_from_pointer_to_member(
+  Member Parent::* ptr_to_member)
+{
+	const detail::offset_probe<Parent> probe;
+	const void * const member = &(probe.object.*ptr_to_member);
+	for (std::size_t i = 0; i < sizeof(Parent); ++i) {
+		if (static_cast<const void*>(probe.bytes + i) == member) {
+			return std::ptrdiff_t(i);
+		}
+	}
+	return -1;
+}
+
 template <class Parent, class Member>
 inline std::ptrdiff_t offset_from_pointer_to_member(
   const Member Parent::* ptr_to_member)
@@ -45,6 +87,33 @@ inline const Parent *parent_from_member(const Member *member,
 	  offset_from_pointer_to_member(ptr_to_member)));
 }
 
+// The following overloads take the pointer to member as a template
+// argument, so the offset is a compile-time constant and the conversion
+// is a single constant adjustment of the member address.
+template<auto PtrToMember, class Member,
+  class Parent = typename member_pointer_traits<
+  decltype(PtrToMember)>::parent_type>
+inline Parent *parent_from_member(Member *member)
+{
+	constexpr std::ptrdiff_t offset =
+	  constexpr_offset_from_pointer_to_member(PtrToMember);
+	static_assert(offset >= 0, "member not found in parent");
+	return static_cast<Parent*>(static_cast<void*>(
+	  static_cast<char*>(static_cast<void*>(member)) - offset));
+}
+
+template<auto PtrToMember, class Member,
+  class Parent = typename member_pointer_traits<
+  decltype(PtrToMember)>::parent_type>
+inline const Parent *parent_from_member(const Member *member)
+{
+	constexpr std::ptrdiff_t offset =
+	  constexpr_offset_from_pointer_to_member(PtrToMember);
+	static_assert(offset >= 0, "member not found in parent");
+	return static_cast<const Parent*>(static_cast<const void*>(
+	  static_cast<const char*>(static_cast<const void*>(member)) - offset));
+}
+
 }
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef ra_reclaim_barrier_hpp
+#define ra_reclaim_barrier_hpp
+
+#include <atomic>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ra::reclaim::detail {
+    // Asymmetric memory barriers.
+    //
+    // A reader announces that it is about to read shared objects (by a store)
+    // and then reads them, while a reclaimer unlinks objects and then reads
+    // the announcements. Each side needs a store-load barrier between its
+    // store and its loads, but readers run far more often than reclaimers.
+    // Where the operating system can interrupt every running thread of the
+    // process with a memory barrier (membarrier on Linux), the reader side
+    // only has to keep the compiler from reordering (light_barrier), and the
+    // reclaimer side pays for the process-wide barrier (heavy_barrier).
+    // Elsewhere, both sides are sequentially consistent fences.
+
+#if defined(__linux__) && defined(__NR_membarrier)
+    // Registers the process for expedited membarrier, and returns true on
+    // success.
+    inline bool register_membarrier() {
+        return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    }
+
+    // Whether heavy_barrier interrupts every running thread of the process.
+    // This is only ever changed from false to true (during static
+    // initialization), and a reader that sees false issues a full fence, so
+    // the two sides cannot disagree in an unsafe way.
+    inline const bool membarrier_enabled = register_membarrier();
+#else
+    inline const bool membarrier_enabled = false;
+#endif
+
+    // The reader side of an asymmetric store-load barrier.
+    inline void light_barrier() {
+        if (membarrier_enabled) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    // The reclaimer side of an asymmetric store-load barrier.
+    inline void heavy_barrier() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#if defined(__linux__) && defined(__NR_membarrier)
+        if (membarrier_enabled) {
+            syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        }
+#endif
+    }
+}  // namespace ra::reclaim::detail
+
+#endif
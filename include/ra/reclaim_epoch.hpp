@@ -0,0 +1,305 @@
+#ifndef ra_reclaim_epoch_hpp
+#define ra_reclaim_epoch_hpp
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ra/intrusive_list.hpp>
+#include <ra/reclaim_barrier.hpp>
+#include <ra/reclaim_retire_hook.hpp>
+
+namespace ra::reclaim {
+    // Epoch-based reclamation domain.
+    //
+    // An object that has been unlinked from a shared data structure may still
+    // be read by threads that found it before it was unlinked. Such an object
+    // is retired (instead of being freed), and the domain disposes of it once
+    // no thread can still hold a reference to it.
+    //
+    // Each thread that reads shared objects or retires them does so through
+    // its own participant of the domain. A participant is pinned while it
+    // reads shared objects (see guard), and pinning announces the global
+    // epoch that the participant observed. The global epoch advances only
+    // when every pinned participant has observed the current epoch, so an
+    // object retired in epoch e can no longer be reached by any reader once
+    // the global epoch reaches e + 2.
+    //
+    // Retired objects are kept in a limbo list per participant, threaded
+    // through the retire_hook of each object (so retiring never allocates).
+    // Retirement is batched: only once batch_size() objects have accumulated
+    // does a participant try to advance the epoch and dispose of the objects
+    // that have become safe. Pinning and unpinning touch only the cache line
+    // of the participant and need no hardware fence where the operating
+    // system supports asymmetric barriers (the cost is moved to try_advance,
+    // see reclaim_barrier.hpp), and nested pins are free.
+    class epoch_domain {
+        public:
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The type used to represent epochs.
+            using epoch_type = std::uint64_t;
+
+            class participant;
+            class guard;
+
+            // Construct a domain.
+            //
+            // Creates a domain without participants, whose participants try to
+            // reclaim their limbo lists each time batch_size more objects have
+            // been retired.
+            //
+            // Time complexity:
+            // Constant.
+            explicit epoch_domain(size_type batch_size = 64) : global_(0), batch_size_(batch_size ? batch_size : 1) {}
+
+            // Destroy a domain.
+            //
+            // Disposes of the objects left behind by participants. All of the
+            // participants must have been destroyed.
+            //
+            // Time complexity:
+            // Linear in the number of retired objects.
+            ~epoch_domain() {
+                assert(participants_.empty());
+                orphans_.dispose_all();
+            }
+
+            // Do not allow the copying of domains.
+            epoch_domain(const epoch_domain&) = delete;
+            epoch_domain& operator=(const epoch_domain&) = delete;
+
+            // Returns the current global epoch.
+            //
+            // Time complexity:
+            // Constant.
+            epoch_type epoch() const {
+                return global_.load(std::memory_order_relaxed);
+            }
+
+            // Returns the number of objects retired before each attempt to
+            // reclaim a limbo list.
+            //
+            // Time complexity:
+            // Constant.
+            size_type batch_size() const {
+                return batch_size_;
+            }
+
+            // Advances the global epoch if every pinned participant has
+            // observed the current epoch, and disposes of the objects left by
+            // destroyed participants that have become safe to reclaim.
+            // Returns true if the epoch advanced.
+            //
+            // Time complexity:
+            // Linear in the number of participants (plus the number of objects
+            // left by destroyed participants).
+            bool try_advance();
+
+            // Per-thread participant of a domain.
+            // A participant must only be used by one thread at a time, and must
+            // be destroyed before its domain.
+            class participant {
+                public:
+                    // Construct a participant of the domain d.
+                    //
+                    // Time complexity:
+                    // Linear in the number of participants.
+                    explicit participant(epoch_domain& d) : local_(0), domain_(&d), nest_(0), next_collect_(d.batch_size_) {
+                        std::lock_guard<std::mutex> lock(d.mutex_);
+                        d.participants_.push_back(*this);
+                    }
+
+                    // Destroy a participant.
+                    //
+                    // The participant must not be pinned. Its retired objects are
+                    // handed over to the domain, which disposes of them once they
+                    // become safe to reclaim.
+                    //
+                    // Time complexity:
+                    // Linear in the number of participants.
+                    ~participant() {
+                        assert(!pinned());
+                        std::lock_guard<std::mutex> lock(domain_->mutex_);
+                        domain_->participants_.erase(decltype(domain_->participants_)::s_iterator_to(*this));
+                        domain_->orphans_.splice(limbo_);
+                    }
+
+                    // Do not allow the copying of participants.
+                    participant(const participant&) = delete;
+                    participant& operator=(const participant&) = delete;
+
+                    // Pins the participant, so that no object that is reachable
+                    // now is reclaimed until the participant is unpinned. Pins
+                    // nest: the participant is unpinned by the unpin matching its
+                    // outermost pin.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    void pin() {
+                        if (nest_++ == 0) {
+                            epoch_type e = domain_->global_.load(std::memory_order_relaxed);
+                            local_.store(e << 1 | 1, std::memory_order_relaxed);
+                            // Order the announcement before the reads of shared
+                            // objects that follow (see light_barrier).
+                            detail::light_barrier();
+                        }
+                    }
+
+                    // Unpins the participant.
+                    //
+                    // Precondition:
+                    // The participant is pinned.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    void unpin() {
+                        assert(nest_ > 0);
+                        if (--nest_ == 0) {
+                            local_.store(0, std::memory_order_release);
+                        }
+                    }
+
+                    // Returns true if the participant is pinned.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    bool pinned() const {
+                        return nest_ != 0;
+                    }
+
+                    // Retires the object x, whose retire_hook is selected by Hook
+                    // (see ra::intrusive::hook_traits). The object must have been
+                    // unlinked from every shared data structure, and is disposed
+                    // of with Disposer()(&x) once no participant can still hold a
+                    // reference to it.
+                    //
+                    // Time complexity:
+                    // Constant (amortized over a batch when reclaiming).
+                    template <auto Hook, class Disposer = delete_disposer, class T>
+                    void retire(T& x) {
+                        // The fence orders the unlinking of x before the read of
+                        // the epoch.
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        limbo_.push_back<Hook, Disposer>(x, domain_->global_.load(std::memory_order_relaxed));
+                        if (limbo_.size() >= next_collect_) {
+                            collect();
+                        }
+                    }
+
+                    // Tries to advance the global epoch, and disposes of the
+                    // retired objects of the participant that have become safe
+                    // to reclaim. Returns the number of objects disposed of.
+                    //
+                    // Time complexity:
+                    // Linear in the number of participants plus the number of
+                    // objects disposed of.
+                    size_type collect() {
+                        domain_->try_advance();
+                        epoch_type now = domain_->global_.load(std::memory_order_acquire);
+                        // The limbo list is in retirement order, so its epochs
+                        // never decrease.
+                        size_type count = limbo_.dispose_front_while([now](std::uintptr_t e) { return e + 2 <= now; });
+                        next_collect_ = limbo_.size() + domain_->batch_size_;
+                        return count;
+                    }
+
+                    // Returns the number of retired objects of the participant
+                    // that have not been disposed of.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    size_type retired_count() const {
+                        return limbo_.size();
+                    }
+
+                private:
+                    // The announced epoch (shifted left by one), with the low bit
+                    // set while the participant is pinned. It is read by other
+                    // threads, so it gets a cache line of its own.
+                    alignas(64) std::atomic<epoch_type> local_;
+
+                    alignas(64) epoch_domain* domain_;
+
+                    // The depth of nested pins.
+                    size_type nest_;
+
+                    // The size of the limbo list at which collect is next called.
+                    size_type next_collect_;
+
+                    // The retired objects, in retirement order.
+                    detail::retired_list limbo_;
+
+                    // Links the participant into the registry of the domain.
+                    ra::intrusive::list_hook hook_;
+
+                    friend class epoch_domain;
+            };
+
+            // RAII pin.
+            // A guard pins a participant for its lifetime.
+            class guard {
+                public:
+                    // Pins the participant p.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    explicit guard(participant& p) : participant_(&p) {
+                        p.pin();
+                    }
+
+                    // Unpins the participant.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    ~guard() {
+                        participant_->unpin();
+                    }
+
+                    // Do not allow the copying of guards.
+                    guard(const guard&) = delete;
+                    guard& operator=(const guard&) = delete;
+
+                private:
+                    participant* participant_;
+            };
+
+        private:
+            // The global epoch.
+            alignas(64) std::atomic<epoch_type> global_;
+
+            alignas(64) size_type batch_size_;
+
+            // Guards the registry and the orphans.
+            std::mutex mutex_;
+
+            // The registry of participants.
+            ra::intrusive::list<participant, &participant::hook_> participants_;
+
+            // The retired objects left by destroyed participants.
+            detail::retired_list orphans_;
+    };
+
+    inline bool epoch_domain::try_advance() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        epoch_type e = global_.load(std::memory_order_relaxed);
+        // This pairs with the light barrier in pin, so that a participant
+        // either is seen pinned here or sees the objects already unlinked.
+        detail::heavy_barrier();
+        for (const participant& p : participants_) {
+            epoch_type local = p.local_.load(std::memory_order_relaxed);
+            if ((local & 1) && (local >> 1) != e) {
+                return false;
+            }
+        }
+        global_.store(e + 1, std::memory_order_release);
+
+        orphans_.dispose_if([e](std::uintptr_t r) { return r + 2 <= e + 1; });
+        return true;
+    }
+}  // namespace ra::reclaim
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef ra_reclaim_hazard_pointer_hpp
+#define ra_reclaim_hazard_pointer_hpp
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ra/intrusive_list.hpp>
+#include <ra/reclaim_barrier.hpp>
+#include <ra/reclaim_retire_hook.hpp>
+#include <vector>
+
+namespace ra::reclaim {
+    // Hazard-pointer reclamation domain.
+    //
+    // This is the bounded-memory counterpart of epoch_domain. Instead of
+    // pinning a whole epoch, a reader publishes the address of each shared
+    // object it is about to read in one of the Slots hazard pointers of its
+    // participant (see protect), and a retired object is disposed of as soon
+    // as no hazard pointer holds its address. A stalled reader thus delays
+    // the reclamation of at most Slots objects, rather than of every object
+    // retired since it was pinned, so each participant holds at most
+    // batch_size() plus the total number of hazard pointers retired objects.
+    //
+    // As with epoch_domain, retired objects are threaded through their
+    // retire_hook, and retirement is batched: once batch_size() objects have
+    // accumulated, a participant scans the hazard pointers of all of the
+    // participants (sorting them once) and disposes of the unprotected
+    // objects.
+    template <std::size_t Slots = 2>
+    class hazard_domain {
+        public:
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The number of hazard pointers of each participant.
+            static constexpr size_type slots = Slots;
+
+            class participant;
+
+            // Construct a domain.
+            //
+            // Creates a domain without participants, whose participants scan the
+            // hazard pointers each time batch_size more objects have been
+            // retired.
+            //
+            // Time complexity:
+            // Constant.
+            explicit hazard_domain(size_type batch_size = 64) : batch_size_(batch_size ? batch_size : 1) {}
+
+            // Destroy a domain.
+            //
+            // Disposes of the objects left behind by participants. All of the
+            // participants must have been destroyed.
+            //
+            // Time complexity:
+            // Linear in the number of retired objects.
+            ~hazard_domain() {
+                assert(participants_.empty());
+                orphans_.dispose_all();
+            }
+
+            // Do not allow the copying of domains.
+            hazard_domain(const hazard_domain&) = delete;
+            hazard_domain& operator=(const hazard_domain&) = delete;
+
+            // Returns the number of objects retired before each scan of the
+            // hazard pointers.
+            //
+            // Time complexity:
+            // Constant.
+            size_type batch_size() const {
+                return batch_size_;
+            }
+
+            // Per-thread participant of a domain, which owns slots hazard
+            // pointers. A participant must only be used by one thread at a time,
+            // and must be destroyed before its domain.
+            class participant {
+                public:
+                    // Construct a participant of the domain d, whose hazard
+                    // pointers are all clear.
+                    //
+                    // Time complexity:
+                    // Linear in the number of participants.
+                    explicit participant(hazard_domain& d) : domain_(&d), next_scan_(d.batch_size_) {
+                        for (auto& h : hazards_) {
+                            h.store(nullptr, std::memory_order_relaxed);
+                        }
+                        std::lock_guard<std::mutex> lock(d.mutex_);
+                        d.participants_.push_back(*this);
+                    }
+
+                    // Destroy a participant.
+                    //
+                    // The hazard pointers of the participant are cleared, and its
+                    // retired objects are handed over to the domain, which
+                    // disposes of them in a later scan.
+                    //
+                    // Time complexity:
+                    // Linear in the number of participants.
+                    ~participant() {
+                        std::lock_guard<std::mutex> lock(domain_->mutex_);
+                        domain_->participants_.erase(decltype(domain_->participants_)::s_iterator_to(*this));
+                        domain_->orphans_.splice(retired_);
+                    }
+
+                    // Do not allow the copying of participants.
+                    participant(const participant&) = delete;
+                    participant& operator=(const participant&) = delete;
+
+                    // Loads the pointer src and protects the object it points to
+                    // with the hazard pointer with the index slot, retrying until
+                    // src is seen unchanged after the hazard pointer is published.
+                    // The returned object (if not null) is not reclaimed until the
+                    // hazard pointer is cleared or reused.
+                    //
+                    // Precondition:
+                    // slot < slots.
+                    //
+                    // Time complexity:
+                    // Constant (plus one retry for each concurrent change of src).
+                    template <class T>
+                    T* protect(size_type slot, const std::atomic<T*>& src) {
+                        assert(slot < slots);
+                        T* p = src.load(std::memory_order_relaxed);
+                        for (;;) {
+                            hazards_[slot].store(p, std::memory_order_relaxed);
+                            // Order the publication before the validating load
+                            // (see light_barrier).
+                            detail::light_barrier();
+                            T* q = src.load(std::memory_order_acquire);
+                            if (q == p) {
+                                return p;
+                            }
+                            p = q;
+                        }
+                    }
+
+                    // Clears the hazard pointer with the index slot.
+                    //
+                    // Precondition:
+                    // slot < slots.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    void clear(size_type slot) {
+                        assert(slot < slots);
+                        hazards_[slot].store(nullptr, std::memory_order_release);
+                    }
+
+                    // Clears all of the hazard pointers of the participant.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    void clear() {
+                        for (auto& h : hazards_) {
+                            h.store(nullptr, std::memory_order_release);
+                        }
+                    }
+
+                    // Retires the object x, whose retire_hook is selected by Hook
+                    // (see ra::intrusive::hook_traits). The object must have been
+                    // unlinked from every shared data structure, and is disposed
+                    // of with Disposer()(&x) once no hazard pointer protects it.
+                    //
+                    // Time complexity:
+                    // Constant (amortized over a batch when scanning).
+                    template <auto Hook, class Disposer = delete_disposer, class T>
+                    void retire(T& x) {
+                        retired_.push_back<Hook, Disposer>(x, reinterpret_cast<std::uintptr_t>(&x));
+                        if (retired_.size() >= next_scan_) {
+                            collect();
+                        }
+                    }
+
+                    // Scans the hazard pointers of all of the participants, and
+                    // disposes of the retired objects of the participant (and of
+                    // destroyed participants) that are not protected. Returns the
+                    // number of objects disposed of.
+                    //
+                    // Time complexity:
+                    // O(H log H + R log H), where H is the number of hazard
+                    // pointers and R is the number of retired objects.
+                    size_type collect() {
+                        // Order the unlinking of the retired objects before the
+                        // reads of the hazard pointers (see heavy_barrier).
+                        detail::heavy_barrier();
+
+                        size_type count;
+                        {
+                            std::lock_guard<std::mutex> lock(domain_->mutex_);
+                            scratch_.clear();
+                            for (const participant& p : domain_->participants_) {
+                                for (const auto& h : p.hazards_) {
+                                    if (const void* q = h.load(std::memory_order_acquire)) {
+                                        scratch_.push_back(reinterpret_cast<std::uintptr_t>(q));
+                                    }
+                                }
+                            }
+                            std::sort(scratch_.begin(), scratch_.end());
+                            auto unprotected = [this](std::uintptr_t r) {
+                                return !std::binary_search(scratch_.begin(), scratch_.end(), r);
+                            };
+                            count = domain_->orphans_.dispose_if(unprotected);
+                            count += retired_.dispose_if(unprotected);
+                        }
+
+                        next_scan_ = retired_.size() + domain_->batch_size_;
+                        return count;
+                    }
+
+                    // Returns the number of retired objects of the participant
+                    // that have not been disposed of.
+                    //
+                    // Time complexity:
+                    // Constant.
+                    size_type retired_count() const {
+                        return retired_.size();
+                    }
+
+                private:
+                    // The hazard pointers, which are read by other threads, so
+                    // they get a cache line of their own.
+                    alignas(64) std::array<std::atomic<const void*>, slots> hazards_;
+
+                    alignas(64) hazard_domain* domain_;
+
+                    // The size of the retired list at which collect is next
+                    // called.
+                    size_type next_scan_;
+
+                    // The retired objects.
+                    detail::retired_list retired_;
+
+                    // The sorted hazard pointers found by the last scan.
+                    std::vector<std::uintptr_t> scratch_;
+
+                    // Links the participant into the registry of the domain.
+                    ra::intrusive::list_hook hook_;
+
+                    friend class hazard_domain;
+            };
+
+        private:
+            size_type batch_size_;
+
+            // Guards the registry and the orphans.
+            std::mutex mutex_;
+
+            // The registry of participants.
+            ra::intrusive::list<participant, &participant::hook_> participants_;
+
+            // The retired objects left by destroyed participants.
+            detail::retired_list orphans_;
+    };
+}  // namespace ra::reclaim
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef ra_reclaim_retire_hook_hpp
+#define ra_reclaim_retire_hook_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <ra/intrusive_hook_traits.hpp>
+#include <type_traits>
+
+namespace ra::reclaim {
+    namespace detail {
+        class retired_list;
+    }  // namespace detail
+
+    // The default disposer of retired objects, which deletes them.
+    struct delete_disposer {
+        template <class T>
+        void operator()(T* p) const {
+            delete p;
+        }
+    };
+
+    // Per-object retirement information class.
+    // This type contains the information that a reclamation domain keeps for
+    // an object that has been retired (i.e., unlinked from a shared data
+    // structure, but possibly still being read by other threads): the next
+    // object in the list of retired objects, the function that disposes of
+    // the object, and a tag (the epoch of retirement or the address of the
+    // object, depending on the domain). Since the information lives in the
+    // object, retiring an object never allocates memory.
+    class retire_hook {
+        public:
+            // Default construct a retire hook.
+            retire_hook() : next_(nullptr), dispose_(nullptr), tag_(0) {}
+
+            // Copy construct a retire hook.
+            // This constructor creates a retire hook that is not retired. The
+            // argument to the constructor is ignored.
+            retire_hook(const retire_hook&) : retire_hook() {}
+
+            // Copy assign a retire hook.
+            // The copy assignment operator is defined as a no-op. The argument to
+            // the operator is ignored.
+            retire_hook& operator=(const retire_hook&) { return *this; }
+
+            // Destroy a retire hook.
+            ~retire_hook() = default;
+
+        private:
+            // The next retired object.
+            retire_hook* next_;
+            // Disposes of the object containing the hook.
+            void (*dispose_)(retire_hook*);
+            // The epoch of retirement or the address of the object.
+            std::uintptr_t tag_;
+
+            friend class detail::retired_list;
+    };
+
+    namespace detail {
+        // Disposes of the object of type T containing the hook h (selected by
+        // the hook selector Hook) with a Disposer.
+        template <class T, auto Hook, class Disposer>
+        void dispose(retire_hook* h) {
+            Disposer()(ra::intrusive::hook_traits<T, Hook>::to_value(h));
+        }
+
+        // A FIFO list of retired objects, threaded through their retire hooks.
+        class retired_list {
+            public:
+                retired_list() : head_(nullptr), tail_(nullptr), size_(0) {}
+
+                retired_list(const retired_list&) = delete;
+                retired_list& operator=(const retired_list&) = delete;
+
+                ~retired_list() {
+                    dispose_all();
+                }
+
+                std::size_t size() const {
+                    return size_;
+                }
+
+                bool empty() const {
+                    return head_ == nullptr;
+                }
+
+                // Appends the object x (whose hook is selected by Hook) with the
+                // tag tag, to be disposed of with a Disposer.
+                template <auto Hook, class Disposer, class T>
+                void push_back(T& x, std::uintptr_t tag) {
+                    static_assert(std::is_same_v<typename ra::intrusive::hook_traits<T, Hook>::hook_type, retire_hook>,
+                                  "Hook must select a retire_hook");
+
+                    retire_hook* h = ra::intrusive::hook_traits<T, Hook>::to_hook(&x);
+                    h->dispose_ = &dispose<T, Hook, Disposer>;
+                    h->tag_ = tag;
+                    append(h);
+                }
+
+                // Moves the objects of other to the end of the list.
+                void splice(retired_list& other) {
+                    if (other.empty()) {
+                        return;
+                    }
+                    if (tail_) {
+                        tail_->next_ = other.head_;
+                    } else {
+                        head_ = other.head_;
+                    }
+                    tail_ = other.tail_;
+                    size_ += other.size_;
+                    other.head_ = nullptr;
+                    other.tail_ = nullptr;
+                    other.size_ = 0;
+                }
+
+                // Disposes of the objects at the front of the list as long as
+                // pred(tag) is true for their tags. The number of objects
+                // disposed of is returned.
+                template <class Pred>
+                std::size_t dispose_front_while(Pred pred) {
+                    std::size_t count = 0;
+                    while (head_ && pred(head_->tag_)) {
+                        retire_hook* h = head_;
+                        head_ = h->next_;
+                        if (!head_) {
+                            tail_ = nullptr;
+                        }
+                        --size_;
+                        h->dispose_(h);
+                        ++count;
+                    }
+                    return count;
+                }
+
+                // Disposes of every object in the list for which pred(tag) is
+                // true for its tag, keeping the others in order. The number of
+                // objects disposed of is returned.
+                template <class Pred>
+                std::size_t dispose_if(Pred pred) {
+                    retire_hook* h = head_;
+                    head_ = nullptr;
+                    tail_ = nullptr;
+                    size_ = 0;
+
+                    std::size_t count = 0;
+                    while (h) {
+                        retire_hook* next = h->next_;
+                        if (pred(h->tag_)) {
+                            h->dispose_(h);
+                            ++count;
+                        } else {
+                            append(h);
+                        }
+                        h = next;
+                    }
+                    return count;
+                }
+
+                // Disposes of all of the objects in the list.
+                std::size_t dispose_all() {
+                    return dispose_front_while([](std::uintptr_t) { return true; });
+                }
+
+            private:
+                void append(retire_hook* h) {
+                    h->next_ = nullptr;
+                    if (tail_) {
+                        tail_->next_ = h;
+                    } else {
+                        head_ = h;
+                    }
+                    tail_ = h;
+                    ++size_;
+                }
+
+                retire_hook* head_;
+                retire_hook* tail_;
+                std::size_t size_;
+        };
+    }  // namespace detail
+}  // namespace ra::reclaim
+
+#endif
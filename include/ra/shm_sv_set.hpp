@@ -0,0 +1,626 @@
+#ifndef ra_shm_sv_set_hpp
+#define ra_shm_sv_set_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include <new>
+#include <ra/sv_set.hpp>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace ra::container {
+    namespace detail {
+        // Throws the error of the last failed system call.
+        [[noreturn]] inline void throw_errno(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        // Closes a file descriptor when it goes out of scope.
+        class fd_guard {
+            public:
+                explicit fd_guard(int fd) : fd_(fd) {}
+                fd_guard(const fd_guard&) = delete;
+                fd_guard& operator=(const fd_guard&) = delete;
+                ~fd_guard() {
+                    if (fd_ >= 0) {
+                        ::close(fd_);
+                    }
+                }
+
+                int get() const {
+                    return fd_;
+                }
+
+                // Gives up the ownership of the descriptor, and returns it.
+                int release() {
+                    return std::exchange(fd_, -1);
+                }
+
+            private:
+                int fd_;
+        };
+
+        // An owned memory mapping.
+        class mapping {
+            public:
+                mapping() : addr_(nullptr), length_(0) {}
+
+                // Maps length bytes of the file fd (read-only, unless writable
+                // is true), shared with every other mapping of the file.
+                mapping(int fd, std::size_t length, bool writable) : length_(length) {
+                    addr_ = ::mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+                    if (addr_ == MAP_FAILED) {
+                        addr_ = nullptr;
+                        throw_errno("mmap");
+                    }
+                }
+
+                mapping(mapping&& other)
+                    : addr_(std::exchange(other.addr_, nullptr)), length_(std::exchange(other.length_, 0)) {}
+
+                mapping& operator=(mapping&& other) {
+                    if (this != &other) {
+                        reset();
+                        addr_ = std::exchange(other.addr_, nullptr);
+                        length_ = std::exchange(other.length_, 0);
+                    }
+                    return *this;
+                }
+
+                ~mapping() {
+                    reset();
+                }
+
+                void reset() {
+                    if (addr_) {
+                        ::munmap(addr_, length_);
+                        addr_ = nullptr;
+                        length_ = 0;
+                    }
+                }
+
+                std::byte* data() const {
+                    return static_cast<std::byte*>(addr_);
+                }
+
+                std::size_t size() const {
+                    return length_;
+                }
+
+            private:
+                void* addr_;
+                std::size_t length_;
+        };
+
+        // The header at the start of a shared set image. The image is
+        // position-independent: it holds no pointers, only the offset of the
+        // element array from the start of the image, so each process may map
+        // it at a different address.
+        struct shm_image_header {
+            static constexpr std::uint64_t expected_magic = 0x7261737673657431;  // "rasvset1"
+
+            std::uint64_t magic;
+            std::uint64_t generation;
+            std::uint64_t key_size;
+            std::uint64_t key_align;
+            std::uint64_t size;
+            std::uint64_t data_offset;
+            std::uint64_t bytes;
+        };
+
+        // The offset of the element array in an image (a whole number of cache
+        // lines, so that the array is suitably aligned for any key).
+        template <class Key>
+        constexpr std::size_t shm_data_offset() {
+            constexpr std::size_t align = std::max<std::size_t>(alignof(Key), 64);
+            return (sizeof(shm_image_header) + align - 1) / align * align;
+        }
+
+        // The control block at the start of the named control segment of a
+        // publisher, through which subscribers find the current image.
+        struct shm_control {
+            std::uint64_t magic;
+            // The generation of the current image (zero if none has been
+            // published yet).
+            std::atomic<std::uint64_t> generation;
+        };
+
+        // Returns the name of the shared memory object holding the image of
+        // the generation g published under the control segment name.
+        inline std::string shm_image_name(const std::string& name, std::uint64_t g) {
+            return name + "." + std::to_string(g);
+        }
+
+        // The generation is read and written by different processes through
+        // their own mappings, which requires a lock-free (address-free) atomic.
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    }  // namespace detail
+
+    // A read-only set of unique elements in shared memory.
+    //
+    // A shm_sv_set is a view of a set image: a header followed by the sorted
+    // array of elements, as an sv_set would hold them. The image is built
+    // once (see write_image, or shm_sv_set_publisher), and then mapped
+    // read-only by any number of processes, which share the same physical
+    // pages, so each process gets the set without copying or rebuilding it.
+    // Since the image holds offsets rather than pointers, it may be mapped at
+    // a different address in each process.
+    //
+    // The key type must be trivially copyable (i.e., its bytes are its value,
+    // and it holds no pointers into the memory of the process that built the
+    // image), and the comparison object must be default constructible, since
+    // each process uses its own.
+    template <class Key, class Compare = std::less<Key>>
+    class shm_sv_set {
+            static_assert(std::is_trivially_copyable_v<Key>, "The keys of a shared set must be trivially copyable");
+
+            using header = detail::shm_image_header;
+
+        public:
+            // A dummy type used to indicate that elements in a range are
+            // both ordered and unique.
+            using ordered_and_unique_range = typename sv_set<Key, Compare>::ordered_and_unique_range;
+
+            // The type of the elements held by the container.
+            using value_type = Key;
+            using key_type = Key;
+
+            // The type of the function/functor used to compare two keys.
+            using key_compare = Compare;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // The (random-access) iterator types for the container. Since the
+            // elements are mapped read-only, both are non-mutating.
+            using const_iterator = const Key*;
+            using iterator = const_iterator;
+
+            // Default construct a set.
+            //
+            // Creates an empty set that maps no image.
+            //
+            // Time complexity:
+            // Constant.
+            shm_sv_set() : arr_(nullptr), size_(0), generation_(0) {}
+
+            // Construct a set from an image.
+            //
+            // Maps the image in the file fd (e.g., a descriptor returned by
+            // make_memfd or shm_open) read-only. The descriptor may be closed
+            // afterwards. If the file does not hold a valid image for this key
+            // type, std::runtime_error is thrown, and if a system call fails,
+            // std::system_error is thrown.
+            //
+            // Time complexity:
+            // Constant (the pages of the image are faulted in on first use).
+            explicit shm_sv_set(int fd) : shm_sv_set() {
+                struct stat st;
+                if (::fstat(fd, &st) != 0) {
+                    detail::throw_errno("fstat");
+                }
+                if (static_cast<std::size_t>(st.st_size) < sizeof(header)) {
+                    throw std::runtime_error("shm_sv_set: file too small for an image");
+                }
+                map_ = detail::mapping(fd, static_cast<std::size_t>(st.st_size), false);
+
+                const header* h = reinterpret_cast<const header*>(map_.data());
+                if (h->magic != header::expected_magic || h->key_size != sizeof(Key) || h->key_align != alignof(Key) ||
+                    h->data_offset != detail::shm_data_offset<Key>() || h->bytes < h->data_offset || h->bytes > map_.size() ||
+                    h->size > (h->bytes - h->data_offset) / sizeof(Key)) {
+                    map_.reset();
+                    throw std::runtime_error("shm_sv_set: invalid image");
+                }
+                arr_ = reinterpret_cast<const Key*>(map_.data() + h->data_offset);
+                size_ = h->size;
+                generation_ = h->generation;
+            }
+
+            // Move construct a set.
+            // After the move, other is empty.
+            shm_sv_set(shm_sv_set&& other)
+                : map_(std::move(other.map_)),
+                  arr_(std::exchange(other.arr_, nullptr)),
+                  size_(std::exchange(other.size_, 0)),
+                  generation_(std::exchange(other.generation_, 0)) {}
+
+            // Move assign a set.
+            // After the move, other is empty.
+            shm_sv_set& operator=(shm_sv_set&& other) {
+                if (this != &other) {
+                    map_ = std::move(other.map_);
+                    arr_ = std::exchange(other.arr_, nullptr);
+                    size_ = std::exchange(other.size_, 0);
+                    generation_ = std::exchange(other.generation_, 0);
+                }
+                return *this;
+            }
+
+            // Do not allow the copying of sets.
+            shm_sv_set(const shm_sv_set&) = delete;
+            shm_sv_set& operator=(const shm_sv_set&) = delete;
+
+            // Destroy a set.
+            // The image is unmapped.
+            ~shm_sv_set() = default;
+
+            // Writes the image of the set of the n elements in the range
+            // starting at first to the file fd (which is resized to fit),
+            // tagged with generation. The elements in the range must be both
+            // unique and ordered with respect to key_compare.
+            //
+            // Time complexity:
+            // Linear in n.
+            template <class InputIterator>
+            static void write_image(int fd, ordered_and_unique_range, InputIterator first, size_type n,
+                                    std::uint64_t generation = 0) {
+                constexpr std::size_t offset = detail::shm_data_offset<Key>();
+                std::size_t bytes = offset + n * sizeof(Key);
+                if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                    detail::throw_errno("ftruncate");
+                }
+                detail::mapping map(fd, bytes, true);
+
+                header* h = ::new (map.data()) header;
+                h->magic = 0;
+                h->generation = generation;
+                h->key_size = sizeof(Key);
+                h->key_align = alignof(Key);
+                h->size = n;
+                h->data_offset = offset;
+                h->bytes = bytes;
+                std::uninitialized_copy_n(first, n, reinterpret_cast<Key*>(map.data() + offset));
+                // The image only becomes valid once it is complete.
+                h->magic = header::expected_magic;
+            }
+
+            // Writes the image of the set s to the file fd (see above).
+            static void write_image(int fd, const sv_set<Key, Compare>& s, std::uint64_t generation = 0) {
+                write_image(fd, ordered_and_unique_range(), s.begin(), s.size(), generation);
+            }
+
+#ifdef __linux__
+            // Creates an anonymous memory file (named name for debugging only)
+            // holding the image of the set of the n elements in the range
+            // starting at first, and returns its descriptor. The file is sealed
+            // against any further change, so every process it is shared with
+            // (e.g., the children forked after it was made) can trust it.
+            //
+            // Time complexity:
+            // Linear in n.
+            template <class InputIterator>
+            static int make_memfd(const char* name, ordered_and_unique_range, InputIterator first, size_type n) {
+                detail::fd_guard fd(::memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING));
+                if (fd.get() < 0) {
+                    detail::throw_errno("memfd_create");
+                }
+                write_image(fd.get(), ordered_and_unique_range(), first, n);
+                if (::fcntl(fd.get(), F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+                    detail::throw_errno("fcntl");
+                }
+                return fd.release();
+            }
+
+            // Creates an anonymous memory file holding the image of the set s
+            // (see above).
+            static int make_memfd(const char* name, const sv_set<Key, Compare>& s) {
+                return make_memfd(name, ordered_and_unique_range(), s.begin(), s.size());
+            }
+#endif
+
+            // Get the comparison object for the container.
+            //
+            // Time complexity:
+            // Constant.
+            key_compare key_comp() const {
+                return key_compare();
+            }
+
+            // Get the generation the image was published with (see
+            // shm_sv_set_publisher).
+            //
+            // Time complexity:
+            // Constant.
+            std::uint64_t generation() const noexcept {
+                return generation_;
+            }
+
+            // Get an iterator referring to the first element in the set.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator begin() const noexcept {
+                return arr_;
+            }
+
+            // Get an iterator referring to the one-past-the-end position in the
+            // set.
+            //
+            // Time complexity:
+            // Constant.
+            const_iterator end() const noexcept {
+                return arr_ + size_;
+            }
+
+            // Get the size of the set.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const noexcept {
+                return size_;
+            }
+
+            // Returns true if the set contains no elements.
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const noexcept {
+                return size_ == 0;
+            }
+
+            // Find an element in the set.
+            //
+            // Searches the container for an element with the key k.
+            // If an element is found, an iterator referencing the element
+            // is returned; otherwise, end() is returned.
+            //
+            // Time complexity:
+            // Logarithmic.
+            const_iterator find(const key_type& k) const {
+                key_compare comp;
+                const_iterator it = std::lower_bound(begin(), end(), k, comp);
+                return it != end() && !comp(k, *it) ? it : end();
+            }
+
+            // Returns true if the set contains an element with the key k.
+            //
+            // Time complexity:
+            // Logarithmic.
+            bool contains(const key_type& k) const {
+                return find(k) != end();
+            }
+
+        private:
+            detail::mapping map_;
+
+            const key_type* arr_;
+            size_type size_;
+            std::uint64_t generation_;
+    };
+
+    // The publisher of a versioned shared set.
+    //
+    // A publisher owns a named shared memory control segment (name is a
+    // POSIX shared memory object name such as "/my_set"), which records the
+    // generation of the current image. Each call of publish writes a new
+    // image to its own shared memory object ("<name>.<generation>"), and
+    // then swaps it in by storing its generation in the control segment,
+    // so subscribers (see shm_sv_set_subscriber) switch from one complete
+    // image to the next without ever seeing a partial one. The name of the
+    // previous image is then unlinked; processes that still map it keep it
+    // until they unmap it, when the system frees it.
+    template <class Key, class Compare = std::less<Key>>
+    class shm_sv_set_publisher {
+        public:
+            // The type of the sets published.
+            using set_type = shm_sv_set<Key, Compare>;
+
+            using ordered_and_unique_range = typename set_type::ordered_and_unique_range;
+
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Construct a publisher.
+            //
+            // Creates the control segment name (which must not exist), with the
+            // access permissions mode, without publishing any image. If a system
+            // call fails, std::system_error is thrown.
+            explicit shm_sv_set_publisher(std::string name, mode_t mode = 0644)
+                : name_(std::move(name)), mode_(mode), generation_(0) {
+                detail::fd_guard fd(::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode_));
+                if (fd.get() < 0) {
+                    detail::throw_errno("shm_open");
+                }
+                try {
+                    if (::ftruncate(fd.get(), sizeof(detail::shm_control)) != 0) {
+                        detail::throw_errno("ftruncate");
+                    }
+                    control_map_ = detail::mapping(fd.get(), sizeof(detail::shm_control), true);
+                } catch (...) {
+                    ::shm_unlink(name_.c_str());
+                    throw;
+                }
+                control_ = ::new (control_map_.data()) detail::shm_control;
+                control_->generation.store(0, std::memory_order_relaxed);
+                control_->magic = detail::shm_image_header::expected_magic;
+            }
+
+            // Do not allow the copying of publishers.
+            shm_sv_set_publisher(const shm_sv_set_publisher&) = delete;
+            shm_sv_set_publisher& operator=(const shm_sv_set_publisher&) = delete;
+
+            // Destroy a publisher.
+            //
+            // Unlinks the control segment and the current image. Subscribers
+            // keep the sets they have already obtained, but cannot obtain new
+            // ones.
+            ~shm_sv_set_publisher() {
+                if (generation_ != 0) {
+                    ::shm_unlink(image_name(generation_).c_str());
+                }
+                ::shm_unlink(name_.c_str());
+            }
+
+            // Returns the name of the control segment.
+            const std::string& name() const {
+                return name_;
+            }
+
+            // Returns the generation of the current image (zero if none has
+            // been published yet).
+            std::uint64_t generation() const {
+                return generation_;
+            }
+
+            // Publishes the set of the n elements in the range starting at
+            // first as the next generation, which is returned. The elements in
+            // the range must be both unique and ordered with respect to
+            // key_compare. If a system call fails, std::system_error is thrown,
+            // and the current image remains published.
+            //
+            // Time complexity:
+            // Linear in n.
+            template <class InputIterator>
+            std::uint64_t publish(ordered_and_unique_range, InputIterator first, size_type n) {
+                std::uint64_t next = generation_ + 1;
+                std::string next_name = image_name(next);
+                {
+                    // A stale object left by a crashed publisher may be reused.
+                    detail::fd_guard fd(::shm_open(next_name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, mode_));
+                    if (fd.get() < 0) {
+                        detail::throw_errno("shm_open");
+                    }
+                    try {
+                        set_type::write_image(fd.get(), ordered_and_unique_range(), first, n, next);
+                    } catch (...) {
+                        ::shm_unlink(next_name.c_str());
+                        throw;
+                    }
+                }
+
+                // The image is complete before subscribers can see its
+                // generation.
+                control_->generation.store(next, std::memory_order_release);
+                if (generation_ != 0) {
+                    ::shm_unlink(image_name(generation_).c_str());
+                }
+                generation_ = next;
+                return next;
+            }
+
+            // Publishes the set s as the next generation (see above).
+            std::uint64_t publish(const sv_set<Key, Compare>& s) {
+                return publish(ordered_and_unique_range(), s.begin(), s.size());
+            }
+
+        private:
+            // Returns the name of the image of the generation g.
+            std::string image_name(std::uint64_t g) const {
+                return detail::shm_image_name(name_, g);
+            }
+
+            std::string name_;
+            mode_t mode_;
+
+            detail::mapping control_map_;
+            detail::shm_control* control_;
+
+            // The generation of the current image.
+            std::uint64_t generation_;
+    };
+
+    // The subscriber to a versioned shared set.
+    //
+    // A subscriber maps the control segment of a publisher (see
+    // shm_sv_set_publisher) read-only, and hands out the current image as a
+    // shared snapshot. Checking for a new image is a single load from the
+    // control segment, so a process may call current for every request (or
+    // batch of requests) and picks up a newly published set without a
+    // restart. A snapshot stays valid (and mapped) for as long as it is
+    // held, even after newer images have been published.
+    //
+    // A subscriber must not be used by multiple threads at a time, but the
+    // snapshots it returns may be shared freely.
+    template <class Key, class Compare = std::less<Key>>
+    class shm_sv_set_subscriber {
+        public:
+            // The type of the sets obtained.
+            using set_type = shm_sv_set<Key, Compare>;
+
+            // Construct a subscriber.
+            //
+            // Opens the control segment name of a publisher. If a system call
+            // fails (e.g., because there is no such publisher),
+            // std::system_error is thrown.
+            explicit shm_sv_set_subscriber(std::string name) : name_(std::move(name)) {
+                detail::fd_guard fd(::shm_open(name_.c_str(), O_RDONLY | O_CLOEXEC, 0));
+                if (fd.get() < 0) {
+                    detail::throw_errno("shm_open");
+                }
+                control_map_ = detail::mapping(fd.get(), sizeof(detail::shm_control), false);
+                control_ = reinterpret_cast<const detail::shm_control*>(control_map_.data());
+                if (control_->magic != detail::shm_image_header::expected_magic) {
+                    throw std::runtime_error("shm_sv_set_subscriber: invalid control segment");
+                }
+            }
+
+            // Do not allow the copying of subscribers.
+            shm_sv_set_subscriber(const shm_sv_set_subscriber&) = delete;
+            shm_sv_set_subscriber& operator=(const shm_sv_set_subscriber&) = delete;
+
+            // Returns the generation of the newest published image (zero if
+            // none has been published yet).
+            //
+            // Time complexity:
+            // Constant.
+            std::uint64_t published_generation() const {
+                return control_->generation.load(std::memory_order_acquire);
+            }
+
+            // Returns the newest published set, or null if none has been
+            // published yet. The set is only mapped again when a newer
+            // generation has been published since the last call. If a system
+            // call fails, std::system_error is thrown.
+            //
+            // Time complexity:
+            // Constant.
+            std::shared_ptr<const set_type> current() {
+                for (;;) {
+                    std::uint64_t g = published_generation();
+                    if (g == 0 || (current_ && current_->generation() == g)) {
+                        return current_;
+                    }
+                    detail::fd_guard fd(::shm_open(image_name(g).c_str(), O_RDONLY | O_CLOEXEC, 0));
+                    if (fd.get() < 0) {
+                        // The image was replaced (and unlinked) after its
+                        // generation was read, so try the newer one.
+                        if (errno == ENOENT && published_generation() != g) {
+                            continue;
+                        }
+                        detail::throw_errno("shm_open");
+                    }
+                    current_ = std::make_shared<const set_type>(fd.get());
+                    return current_;
+                }
+            }
+
+        private:
+            // Returns the name of the image of the generation g.
+            std::string image_name(std::uint64_t g) const {
+                return detail::shm_image_name(name_, g);
+            }
+
+            std::string name_;
+
+            detail::mapping control_map_;
+            const detail::shm_control* control_;
+
+            // The set of the newest generation obtained so far.
+            std::shared_ptr<const set_type> current_;
+    };
+}  // namespace ra::container
+
+#endif
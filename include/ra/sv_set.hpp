@@ -1,3 +1,6 @@
+#ifndef ra_sv_set_hpp
+#define ra_sv_set_hpp
+
 #include <algorithm>
 #include <functional>
 #include <memory>
@@ -540,4 +543,6 @@ namespace ra::container {
             size_type capacity_;
             key_compare comp_;
     };
-}  // namespace ra::container
\ No newline at end of file
+}  // namespace ra::container
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef ra_sync_condition_variable_hpp
+#define ra_sync_condition_variable_hpp
+
+#include <cstddef>
+#include <ra/sync_wait_queue.hpp>
+
+namespace ra::sync {
+    // Futex-based condition variable.
+    //
+    // A waiting thread links a waiter on its own stack into the wait queue
+    // of the condition variable before it unlocks the associated lock, so
+    // waiting never allocates memory. Notifications wake the waiters in FIFO
+    // order, and notifying a condition variable that has no waiters does
+    // not touch the queue lock.
+    //
+    // As for std::condition_variable_any, the lock may be any BasicLockable
+    // object (e.g., a std::unique_lock<ra::sync::mutex>).
+    class condition_variable {
+        public:
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Construct a condition variable without waiters.
+            condition_variable() = default;
+
+            // Do not allow the copying of condition variables.
+            condition_variable(const condition_variable&) = delete;
+            condition_variable& operator=(const condition_variable&) = delete;
+
+            // Destroy a condition variable.
+            // The condition variable must not have waiters.
+            ~condition_variable() = default;
+
+            // Atomically unlocks lock and blocks until notified, then locks lock
+            // again. The thread may also be woken by a notification that was
+            // meant for the condition of another waiter, so the condition must
+            // be checked again (see the predicate overload).
+            template <class Lock>
+            void wait(Lock& lock) {
+                waiter w;
+                {
+                    std::lock_guard<wait_queue> q(queue_);
+                    queue_.push(w);
+                }
+                lock.unlock();
+                w.park();
+                lock.lock();
+            }
+
+            // Waits (as above) until pred() is true.
+            template <class Lock, class Predicate>
+            void wait(Lock& lock, Predicate pred) {
+                while (!pred()) {
+                    wait(lock);
+                }
+            }
+
+            // Wakes the oldest waiter, if any.
+            void notify_one() {
+                notify(1);
+            }
+
+            // Wakes the count oldest waiters (or all of them if there are
+            // fewer). The number of waiters woken is returned.
+            size_type notify(size_type count) {
+                // A waiter that the caller must wake was pushed before it
+                // released the lock that orders it with the caller, so it is
+                // visible here.
+                if (queue_.empty()) {
+                    return 0;
+                }
+                return queue_.wake(count);
+            }
+
+            // Wakes all of the waiters. The number of waiters woken is returned.
+            size_type notify_all() {
+                if (queue_.empty()) {
+                    return 0;
+                }
+                return queue_.wake_all();
+            }
+
+        private:
+            wait_queue queue_;
+    };
+}  // namespace ra::sync
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef ra_sync_futex_hpp
+#define ra_sync_futex_hpp
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ra::sync {
+    // Blocks the calling thread while the word w holds the value expected.
+    // The check and the blocking are atomic with respect to futex_wake, so a
+    // wake that follows a change of w cannot be missed. The call may also
+    // return spuriously, so the caller must check w again.
+    //
+    // On Linux this is the private FUTEX_WAIT operation. Elsewhere it falls
+    // back to std::atomic::wait.
+    inline void futex_wait(std::atomic<std::uint32_t>& w, std::uint32_t expected) {
+#if defined(__linux__)
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex words must be 32 bits");
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&w), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        w.wait(expected, std::memory_order_acquire);
+#endif
+    }
+
+    // Wakes up to count threads blocked in futex_wait on the word w.
+    inline void futex_wake(std::atomic<std::uint32_t>& w, int count) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&w), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+        if (count == 1) {
+            w.notify_one();
+        } else {
+            w.notify_all();
+        }
+#endif
+    }
+
+    // Wakes all of the threads blocked in futex_wait on the word w.
+    inline void futex_wake_all(std::atomic<std::uint32_t>& w) {
+        futex_wake(w, INT_MAX);
+    }
+}  // namespace ra::sync
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef ra_sync_latch_hpp
+#define ra_sync_latch_hpp
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <ra/sync_wait_queue.hpp>
+
+namespace ra::sync {
+    // Futex-based single-use barrier.
+    //
+    // Counting down and checking the latch are single atomic operations.
+    // A thread that waits for the latch links a waiter on its own stack into
+    // the wait queue and parks, and the count down that reaches zero wakes
+    // all of the waiters.
+    class latch {
+        public:
+            // A signed integral type used to represent counts.
+            using count_type = std::ptrdiff_t;
+
+            // Construct a latch with the count expected.
+            explicit latch(count_type expected) : count_(expected) {
+                assert(expected >= 0);
+            }
+
+            // Do not allow the copying of latches.
+            latch(const latch&) = delete;
+            latch& operator=(const latch&) = delete;
+
+            // Destroy a latch.
+            // The latch must not have waiters.
+            ~latch() = default;
+
+            // Decrements the count by n, and wakes the waiters if it reaches
+            // zero.
+            //
+            // Precondition:
+            // 0 <= n <= the count.
+            void count_down(count_type n = 1) {
+                count_type old = count_.fetch_sub(n, std::memory_order_acq_rel);
+                assert(old >= n);
+                if (old == n) {
+                    queue_.wake_all();
+                }
+            }
+
+            // Returns true if the count has reached zero.
+            bool try_wait() const {
+                return count_.load(std::memory_order_acquire) == 0;
+            }
+
+            // Blocks until the count reaches zero.
+            void wait() {
+                if (try_wait()) {
+                    return;
+                }
+                waiter w;
+                {
+                    std::lock_guard<wait_queue> lock(queue_);
+                    // The count down that reaches zero takes the queue lock
+                    // before waking, so either it is seen here or it sees w.
+                    if (try_wait()) {
+                        return;
+                    }
+                    queue_.push(w);
+                }
+                w.park();
+            }
+
+            // Decrements the count by n and then waits for it to reach zero.
+            void arrive_and_wait(count_type n = 1) {
+                count_down(n);
+                wait();
+            }
+
+        private:
+            std::atomic<count_type> count_;
+
+            wait_queue queue_;
+    };
+}  // namespace ra::sync
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef ra_sync_mutex_hpp
+#define ra_sync_mutex_hpp
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ra/sync_wait_queue.hpp>
+
+namespace ra::sync {
+    // Futex-based mutex.
+    //
+    // Locking and unlocking an uncontended mutex is a single compare-and-swap
+    // each. A thread that finds the mutex locked links a waiter on its own
+    // stack into the wait queue of the mutex and parks, so contention never
+    // allocates memory. The waiters are woken in FIFO order.
+    //
+    // If Fair is true, unlocking a mutex with waiters hands it directly to
+    // the oldest waiter (the mutex never becomes unlocked in between), so the
+    // waiters acquire the mutex in FIFO order and newcomers cannot barge
+    // ahead of them. The price is that every contended handoff waits for the
+    // waiter to be scheduled, so throughput under heavy contention is far
+    // lower. Otherwise, unlocking releases the mutex and wakes the oldest
+    // waiter to compete for it again (at the front of the queue if it loses).
+    //
+    // The mutex meets the Lockable requirements.
+    template <bool Fair>
+    class basic_mutex {
+        public:
+            // Construct an unlocked mutex.
+            basic_mutex() : state_(unlocked) {}
+
+            // Do not allow the copying of mutexes.
+            basic_mutex(const basic_mutex&) = delete;
+            basic_mutex& operator=(const basic_mutex&) = delete;
+
+            // Destroy a mutex.
+            // The mutex must be unlocked.
+            ~basic_mutex() = default;
+
+            // Locks the mutex, blocking until it is available.
+            void lock() {
+                std::uint32_t expected = unlocked;
+                if (!state_.compare_exchange_strong(expected, locked, std::memory_order_acquire,
+                                                    std::memory_order_relaxed)) {
+                    lock_slow();
+                }
+            }
+
+            // Locks the mutex if it is unlocked, and returns true on success.
+            bool try_lock() {
+                std::uint32_t expected = unlocked;
+                return state_.compare_exchange_strong(expected, locked, std::memory_order_acquire,
+                                                      std::memory_order_relaxed);
+            }
+
+            // Unlocks the mutex, and wakes (or, if Fair, hands the mutex to)
+            // the oldest waiter if there is one.
+            //
+            // Precondition:
+            // The mutex is locked by the calling thread.
+            void unlock() {
+                std::uint32_t expected = locked;
+                if (!state_.compare_exchange_strong(expected, unlocked, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                    unlock_slow();
+                }
+            }
+
+        private:
+            // The states of the mutex. The mutex is contended if the wait queue
+            // may hold waiters (or, if not Fair, a woken waiter may be
+            // competing for the mutex).
+            static constexpr std::uint32_t unlocked = 0;
+            static constexpr std::uint32_t locked = 1;
+            static constexpr std::uint32_t contended = 2;
+
+            void lock_slow() {
+                bool requeue = false;
+                for (;;) {
+                    waiter w;
+                    {
+                        std::lock_guard<wait_queue> lock(queue_);
+                        // The queue lock is held, so the state can still change
+                        // only through the fast paths (between unlocked and
+                        // locked).
+                        std::uint32_t s = state_.load(std::memory_order_relaxed);
+                        for (;;) {
+                            if (s == unlocked) {
+                                // Keep the mutex contended for the waiters left.
+                                std::uint32_t next = queue_.empty() ? locked : contended;
+                                if (state_.compare_exchange_weak(s, next, std::memory_order_acquire,
+                                                                 std::memory_order_relaxed)) {
+                                    return;
+                                }
+                            } else if (s == locked) {
+                                if (state_.compare_exchange_weak(s, contended, std::memory_order_relaxed)) {
+                                    break;
+                                }
+                            } else {
+                                break;
+                            }
+                        }
+                        if (requeue) {
+                            queue_.push_front(w);
+                        } else {
+                            queue_.push(w);
+                        }
+                    }
+                    w.park();
+                    if constexpr (Fair) {
+                        // The unlocking thread handed the mutex over.
+                        return;
+                    }
+                    requeue = true;
+                }
+            }
+
+            void unlock_slow() {
+                waiter* w;
+                {
+                    std::lock_guard<wait_queue> lock(queue_);
+                    w = queue_.pop();
+                    if constexpr (Fair) {
+                        if (!w) {
+                            state_.store(unlocked, std::memory_order_release);
+                        } else if (queue_.empty()) {
+                            state_.store(locked, std::memory_order_relaxed);
+                        }
+                    } else {
+                        // The woken waiter marks the mutex contended again if
+                        // waiters remain.
+                        state_.store(unlocked, std::memory_order_release);
+                    }
+                }
+                if (w) {
+                    w->wake();
+                }
+            }
+
+            std::atomic<std::uint32_t> state_;
+
+            wait_queue queue_;
+    };
+
+    // A mutex that favors throughput: a woken waiter competes with newcomers.
+    using mutex = basic_mutex<false>;
+
+    // A mutex that is handed to its waiters in FIFO order.
+    using fair_mutex = basic_mutex<true>;
+}  // namespace ra::sync
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef ra_sync_semaphore_hpp
+#define ra_sync_semaphore_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <ra/sync_wait_queue.hpp>
+
+namespace ra::sync {
+    // Fair futex-based counting semaphore.
+    //
+    // The count of the semaphore goes negative when threads have to wait,
+    // so that acquiring an available permit and releasing permits that no
+    // thread waits for are a single atomic update each. An acquiring thread
+    // that finds no permit links a waiter on its own stack into the wait
+    // queue and parks. Released permits are handed directly to the waiters
+    // in FIFO order, and a release of n permits wakes up to n waiters with
+    // one pass over the queue.
+    class counting_semaphore {
+        public:
+            // A signed integral type used to represent counts.
+            using count_type = std::ptrdiff_t;
+
+            // Construct a semaphore with desired permits.
+            explicit counting_semaphore(count_type desired) : count_(desired), pending_(0) {
+                assert(desired >= 0);
+            }
+
+            // Do not allow the copying of semaphores.
+            counting_semaphore(const counting_semaphore&) = delete;
+            counting_semaphore& operator=(const counting_semaphore&) = delete;
+
+            // Destroy a semaphore.
+            // The semaphore must not have waiters.
+            ~counting_semaphore() = default;
+
+            // Takes a permit, blocking until one is available.
+            void acquire() {
+                if (count_.fetch_sub(1, std::memory_order_acquire) <= 0) {
+                    acquire_slow();
+                }
+            }
+
+            // Takes a permit if one is available without blocking, and returns
+            // true on success.
+            bool try_acquire() {
+                count_type c = count_.load(std::memory_order_relaxed);
+                while (c > 0) {
+                    if (count_.compare_exchange_weak(c, c - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Adds n permits, handing them to the waiters first.
+            //
+            // Precondition:
+            // n >= 0.
+            void release(count_type n = 1) {
+                assert(n >= 0);
+                count_type old = count_.fetch_add(n, std::memory_order_release);
+                if (old < 0) {
+                    release_slow(std::min(n, -old));
+                }
+            }
+
+            // Returns the number of available permits (which is not negative
+            // even while threads wait). The result is only a snapshot.
+            count_type available() const {
+                return std::max<count_type>(count_.load(std::memory_order_relaxed), 0);
+            }
+
+        private:
+            void acquire_slow() {
+                waiter w;
+                {
+                    std::lock_guard<wait_queue> lock(queue_);
+                    // A releaser may have handed over a permit before this
+                    // thread made it into the queue.
+                    if (pending_ > 0) {
+                        --pending_;
+                        return;
+                    }
+                    queue_.push(w);
+                }
+                w.park();
+            }
+
+            // Hands n permits to the threads that are waiting for one.
+            void release_slow(count_type n) {
+                waiter* woken[16];
+                while (n > 0) {
+                    // Wake the waiters in batches, outside the queue lock.
+                    count_type batch = 0;
+                    {
+                        std::lock_guard<wait_queue> lock(queue_);
+                        while (n > 0 && batch < 16) {
+                            waiter* w = queue_.pop();
+                            if (!w) {
+                                // The remaining acquirers have decremented the
+                                // count but are not queued yet.
+                                pending_ += n;
+                                n = 0;
+                                break;
+                            }
+                            woken[batch++] = w;
+                            --n;
+                        }
+                    }
+                    for (count_type i = 0; i < batch; ++i) {
+                        woken[i]->wake();
+                    }
+                }
+            }
+
+            // The number of available permits, minus the number of threads
+            // that wait for one.
+            std::atomic<count_type> count_;
+
+            // The number of permits handed to acquirers that are not queued
+            // yet (guarded by the queue lock).
+            count_type pending_;
+
+            wait_queue queue_;
+    };
+}  // namespace ra::sync
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef ra_sync_spinlock_hpp
+#define ra_sync_spinlock_hpp
+
+#include <atomic>
+#include <thread>
+
+namespace ra::sync {
+    // Test-and-test-and-set spinlock.
+    // This is meant for critical sections of a few instructions, such as the
+    // relinking of an intrusive list. It meets the Lockable requirements, so
+    // it can be used with std::lock_guard.
+    class spinlock {
+        public:
+            // Construct an unlocked spinlock.
+            spinlock() : locked_(false) {}
+
+            // Do not allow the copying of spinlocks.
+            spinlock(const spinlock&) = delete;
+            spinlock& operator=(const spinlock&) = delete;
+
+            // Acquires the lock, spinning until it is free.
+            void lock() {
+                while (locked_.exchange(true, std::memory_order_acquire)) {
+                    for (int spins = 0; locked_.load(std::memory_order_relaxed); ++spins) {
+                        // Give way to the holder if it may have been preempted.
+                        if (spins < 64) {
+                            pause();
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                }
+            }
+
+            // Acquires the lock if it is free, and returns true on success.
+            bool try_lock() {
+                return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+            }
+
+            // Releases the lock.
+            void unlock() {
+                locked_.store(false, std::memory_order_release);
+            }
+
+        private:
+            // Hints to the processor that the thread is spinning.
+            static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#elif defined(__aarch64__)
+                asm volatile("yield");
+#endif
+            }
+
+            std::atomic<bool> locked_;
+    };
+}  // namespace ra::sync
+
+#endif
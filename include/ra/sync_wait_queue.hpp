@@ -0,0 +1,222 @@
+#ifndef ra_sync_wait_queue_hpp
+#define ra_sync_wait_queue_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ra/intrusive_list.hpp>
+#include <ra/sync_futex.hpp>
+#include <ra/sync_spinlock.hpp>
+
+namespace ra::sync {
+    class wait_queue;
+
+    // Record of a blocked thread.
+    // A thread that has to block creates a waiter on its own stack, links it
+    // into a wait_queue, and parks on the futex word of the waiter until
+    // another thread unlinks it and wakes it. Since each waiter has its own
+    // futex word, exactly the threads chosen by the waker are woken. This
+    // class has the wait_queue class as a friend.
+    class waiter {
+        public:
+            // Construct a waiter that has not been woken.
+            waiter() : woken_(0) {}
+
+            // Do not allow the copying of waiters.
+            waiter(const waiter&) = delete;
+            waiter& operator=(const waiter&) = delete;
+
+            // Destroy a waiter.
+            // The waiter must not belong to a wait queue.
+            ~waiter() = default;
+
+            // Blocks the calling thread until the waiter is woken.
+            void park() {
+                while (woken_.load(std::memory_order_acquire) == 0) {
+                    futex_wait(woken_, 0);
+                }
+            }
+
+            // Wakes the thread parked on the waiter (or lets it return from
+            // park immediately). The waiter must have been unlinked from its
+            // queue, and may be destroyed by its thread as soon as it is
+            // woken.
+            void wake() {
+                woken_.store(1, std::memory_order_release);
+                // Only the address of the word is used here, so it does not
+                // matter whether the waiter has already been destroyed.
+                futex_wake(woken_, 1);
+            }
+
+        private:
+            // Links the waiter into a wait queue.
+            ra::intrusive::list_hook hook_;
+
+            // The futex word, which is set when the waiter is woken.
+            std::atomic<std::uint32_t> woken_;
+
+            friend class wait_queue;
+    };
+
+    // FIFO queue of blocked threads.
+    //
+    // The waiters are linked into an intrusive list guarded by a spinlock,
+    // so blocking never allocates memory. The queue itself meets the
+    // Lockable requirements: a synchronization primitive locks the queue to
+    // decide atomically whether to push a waiter (or to pop waiters), and
+    // wakes the popped waiters after unlocking it.
+    class wait_queue {
+        public:
+            // An unsigned integral type used to represent sizes.
+            using size_type = std::size_t;
+
+            // Construct an empty wait queue.
+            wait_queue() : size_(0) {}
+
+            // Do not allow the copying of wait queues.
+            wait_queue(const wait_queue&) = delete;
+            wait_queue& operator=(const wait_queue&) = delete;
+
+            // Destroy a wait queue.
+            // The queue must be empty.
+            ~wait_queue() = default;
+
+            // Locks the queue.
+            void lock() {
+                lock_.lock();
+            }
+
+            // Locks the queue if it is unlocked, and returns true on success.
+            bool try_lock() {
+                return lock_.try_lock();
+            }
+
+            // Unlocks the queue.
+            void unlock() {
+                lock_.unlock();
+            }
+
+            // Returns the number of waiters in the queue. This may be called
+            // without holding the lock, in which case the result is only a
+            // snapshot.
+            //
+            // Time complexity:
+            // Constant.
+            size_type size() const {
+                return size_.load(std::memory_order_relaxed);
+            }
+
+            // Returns true if the queue holds no waiters (see size).
+            //
+            // Time complexity:
+            // Constant.
+            bool empty() const {
+                return size() == 0;
+            }
+
+            // Appends the waiter w to the queue. The lock must be held.
+            //
+            // Time complexity:
+            // Constant.
+            void push(waiter& w) {
+                waiters_.push_back(w);
+                size_.store(waiters_.size(), std::memory_order_relaxed);
+            }
+
+            // Prepends the waiter w to the queue (e.g., for a woken waiter that
+            // has to wait again without losing its turn). The lock must be
+            // held.
+            //
+            // Time complexity:
+            // Constant.
+            void push_front(waiter& w) {
+                waiters_.insert(waiters_.begin(), w);
+                size_.store(waiters_.size(), std::memory_order_relaxed);
+            }
+
+            // Removes the oldest waiter from the queue, and returns it (or null
+            // if the queue is empty). The lock must be held.
+            //
+            // Time complexity:
+            // Constant.
+            waiter* pop() {
+                if (waiters_.empty()) {
+                    return nullptr;
+                }
+                waiter* w = &*waiters_.begin();
+                waiters_.erase(waiters_.begin());
+                size_.store(waiters_.size(), std::memory_order_relaxed);
+                return w;
+            }
+
+            // Pushes the waiter w and then parks the calling thread on it.
+            // The lock must not be held.
+            void wait(waiter& w) {
+                {
+                    std::lock_guard<wait_queue> lock(*this);
+                    push(w);
+                }
+                w.park();
+            }
+
+            // Wakes the count oldest waiters (or all of them if there are
+            // fewer), in FIFO order. The lock must not be held.
+            // The number of waiters woken is returned.
+            //
+            // Time complexity:
+            // Linear in the number of waiters woken.
+            size_type wake(size_type count) {
+                list_type woken;
+                {
+                    std::lock_guard<wait_queue> lock(*this);
+                    for (size_type i = 0; i < count && !waiters_.empty(); ++i) {
+                        woken.splice(woken.end(), waiters_, waiters_.begin());
+                    }
+                    size_.store(waiters_.size(), std::memory_order_relaxed);
+                }
+                return wake_list(woken);
+            }
+
+            // Wakes all of the waiters. The lock must not be held.
+            // The number of waiters woken is returned.
+            //
+            // Time complexity:
+            // Linear in the number of waiters woken.
+            size_type wake_all() {
+                list_type woken;
+                {
+                    std::lock_guard<wait_queue> lock(*this);
+                    woken.splice(woken.end(), waiters_);
+                    size_.store(0, std::memory_order_relaxed);
+                }
+                return wake_list(woken);
+            }
+
+        private:
+            using list_type = ra::intrusive::list<waiter, &waiter::hook_>;
+
+            // Wakes the waiters of the list l, which is emptied.
+            static size_type wake_list(list_type& l) {
+                size_type count = 0;
+                while (!l.empty()) {
+                    // Unlink the waiter before waking it, since its thread may
+                    // destroy it right away.
+                    waiter& w = *l.begin();
+                    l.erase(l.begin());
+                    w.wake();
+                    ++count;
+                }
+                return count;
+            }
+
+            spinlock lock_;
+
+            list_type waiters_;
+
+            // The number of waiters, readable without the lock.
+            std::atomic<size_type> size_;
+    };
+}  // namespace ra::sync
+
+#endif